@@ -0,0 +1,77 @@
+#include <avr/io.h>
+
+#include <stdint.h>
+
+#include "config.h"
+#include "registers.h"
+
+#include "bus.h"
+#include "nes_apu_channel.h"
+#include "board.h"
+
+static uint8_t keeps_apu_status(uint8_t address)
+{
+    return address == BUS_APU_STATUS || address == BUS_APU_FRAME;
+}
+
+static uint8_t keeps_sq1(uint8_t address)
+{
+    return (address >= BUS_APU + 0x00 && address <= BUS_APU + 0x03) || keeps_apu_status(address);
+}
+
+static uint8_t keeps_sq2(uint8_t address)
+{
+    return (address >= BUS_APU + 0x04 && address <= BUS_APU + 0x07) || keeps_apu_status(address);
+}
+
+static uint8_t keeps_tri(uint8_t address)
+{
+    return (address >= BUS_APU + 0x08 && address <= BUS_APU + 0x0B) || keeps_apu_status(address);
+}
+
+static uint8_t keeps_noise(uint8_t address)
+{
+    return (address >= BUS_APU + 0x0C && address <= BUS_APU + 0x0F) || keeps_apu_status(address);
+}
+
+static uint8_t keeps_vrc6_pulse1(uint8_t address)
+{
+    return address >= BUS_VRC6_PULSE1 && address <= BUS_VRC6_PULSE1 + 0x02;
+}
+
+static uint8_t keeps_vrc6_pulse2(uint8_t address)
+{
+    return address >= BUS_VRC6_PULSE2 && address <= BUS_VRC6_PULSE2 + 0x02;
+}
+
+// One sample interrupt per type of wave, see interrupt.asm
+
+static void init_square()
+{
+    TIMSK1 = _BV(OCIE1A);
+}
+
+static void init_tri()
+{
+    OCR1B = 0; // Match once per period, when the counter is cleared
+    TIMSK1 = _BV(OCIE1B);
+}
+
+static void init_noise()
+{
+    TCCR1B = _BV(WGM13) | _BV(WGM12); // Mode 12, CTC on ICR1
+    TIMSK1 = _BV(ICIE1);
+
+    channel_volume = 0;
+
+    noise_set_mode(0);
+}
+
+const board_t boards[NUM_BOARDS] = {
+    [BOARD_SQ1]         = { keeps_sq1,         init_square, write_reg_sq1,         frame_update_sq },
+    [BOARD_SQ2]         = { keeps_sq2,         init_square, write_reg_sq2,         frame_update_sq },
+    [BOARD_TRI]         = { keeps_tri,         init_tri,    write_reg_tri,         frame_update_tri },
+    [BOARD_NOISE]       = { keeps_noise,       init_noise,  write_reg_noise,       frame_update_noise },
+    [BOARD_VRC6_PULSE1] = { keeps_vrc6_pulse1, init_square, write_reg_vrc6_pulse,  frame_update_vrc6_pulse },
+    [BOARD_VRC6_PULSE2] = { keeps_vrc6_pulse2, init_square, write_reg_vrc6_pulse,  frame_update_vrc6_pulse },
+};
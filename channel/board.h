@@ -0,0 +1,36 @@
+#ifndef BOARD_H_
+#define BOARD_H_
+
+// Board IDs. The ID is read from the EEPROM, written with make board-id, and
+// when that is erased the jumpers select one of the APU channels.
+
+#define BOARD_SQ1          CHAN_SQ1
+#define BOARD_SQ2          CHAN_SQ2
+#define BOARD_TRI          CHAN_TRI
+#define BOARD_NOISE        CHAN_NOISE
+#define BOARD_VRC6_PULSE1  4
+#define BOARD_VRC6_PULSE2  5
+
+#define NUM_BOARDS         6
+
+#define BOARD_ID_EEPROM_ADDR 0
+
+// What a type of board plays. A new type adds its handlers here, and an
+// entry to boards[] in board.c.
+typedef struct
+{
+    // Whether the board keeps the writes to address, see bus_filter
+    uint8_t (*keeps)(uint8_t address);
+
+    // Set timer 1 up for the sample interrupt
+    void (*init)(void);
+
+    void (*write_reg)(uint8_t address, uint8_t val);
+    void (*frame_update)(void);
+} board_t;
+
+extern const board_t boards[NUM_BOARDS];
+
+extern uint8_t bus_filter[256];
+
+#endif
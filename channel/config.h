@@ -6,6 +6,8 @@
 #define CONF0_BIT          0
 #define CONF1_BIT          1
 #define FRAME_FLAG_BIT     2
+#define BUS_ERROR_BIT      3
+#define BUS_DROP_BIT       4
 #define SHIFT_MODE_BIT     7
 
 #ifdef AVR
@@ -22,6 +24,20 @@
 
 #define PINS_DAC_MASK      (_BV(PIN_DAC0) | _BV(PIN_DAC1) | _BV(PIN_DAC2) | _BV(PIN_DAC3))
 
+// Audio out of the second channel of the dual channel firmware, on the pins
+// of CONF1 and the ISP header
+
+#define PINS_DAC_B_PORT    PORTB
+#define PINS_DAC_B_DDR     DDRB
+
+#define PIN_DAC_B0         PORTB2
+#define PIN_DAC_B1         PORTB3
+#define PIN_DAC_B2         PORTB4
+#define PIN_DAC_B3         PORTB5
+
+#define PINS_DAC_B_SHIFT   2
+#define PINS_DAC_B_MASK    (_BV(PIN_DAC_B0) | _BV(PIN_DAC_B1) | _BV(PIN_DAC_B2) | _BV(PIN_DAC_B3))
+
 
 // Bus in
 
@@ -0,0 +1,182 @@
+// Dual channel firmware: both square channels on one board, built with
+// make DUAL=1. Channel 0 plays square 1 on PINS_DAC and channel 1 plays
+// square 2 on PINS_DAC_B, which takes the pin of the CONF1 jumper.
+//
+// Timer 1 runs freely and each channel has a compare unit of its own, OCR1A
+// for channel 0 and OCR1B for channel 1. The sample interrupt of a channel
+// moves its compare value on by the interval of the channel, so the two
+// periods are as exact as on a channel of their own. The state of each
+// channel is kept in a channel_t, as on the host, and what the sample
+// interrupts read is copied to registers after every change.
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include <stdint.h>
+
+#include "config.h"
+#include "registers.h"
+
+#include "io.h"
+#include "bus.h"
+
+#include "nes_apu_channel.h"
+#include "dual.h"
+
+// A sample can be held back by the sample interrupt of the other channel,
+// a bus write and the frame clock, and has to move its compare value on
+// before the timer has passed it, or the channel stops for a whole turn of
+// the timer. The channel Makefile checks that both sample interrupts, the
+// bus interrupt and the frame clock interrupt fit in this many timer ticks,
+// so squares with a period below 17 are played a little flat.
+#define DUAL_MIN_INTERVAL 18
+
+static channel_t channels[2];
+
+void channel_timer_start(void)
+{
+    uint8_t sreg = SREG;
+    cli();
+
+    // Start from a sample period from now, unless it is running already
+    if(current_channel == &channels[0])
+    {
+        if(!(TIMSK1 & _BV(OCIE1A)))
+        {
+            OCR1A = TCNT1 + dual_interval0;
+            TIFR1 = _BV(OCF1A);
+            TIMSK1 |= _BV(OCIE1A);
+        }
+    } else {
+        if(!(TIMSK1 & _BV(OCIE1B)))
+        {
+            OCR1B = TCNT1 + dual_interval1;
+            TIFR1 = _BV(OCF1B);
+            TIMSK1 |= _BV(OCIE1B);
+        }
+    }
+
+    SREG = sreg;
+}
+
+void channel_timer_stop(void)
+{
+    TIMSK1 &= (current_channel == &channels[0]) ? ~_BV(OCIE1A) : ~_BV(OCIE1B);
+}
+
+// As OCR1A in CTC mode, the interval is one more than the period
+void channel_timer_set_period(uint16_t period)
+{
+    uint16_t interval = period + 1;
+
+    if(interval < DUAL_MIN_INTERVAL)
+    {
+        interval = DUAL_MIN_INTERVAL;
+    }
+
+    uint8_t sreg = SREG;
+    cli();
+
+    if(current_channel == &channels[0])
+    {
+        dual_interval0 = interval;
+    } else {
+        dual_interval1 = interval;
+    }
+
+    SREG = sreg;
+}
+
+// Copy what the sample interrupt of the current channel reads
+static void dual_sync(void)
+{
+    if(current_channel == &channels[0])
+    {
+        dual_volume0 = channel.volume;
+        dual_duty_cycle0 = channel.duty_cycle;
+    } else {
+        dual_volume1 = channel.volume << PINS_DAC_B_SHIFT;
+        dual_duty_cycle1 = channel.duty_cycle;
+    }
+}
+
+void dual_write_reg(uint8_t address, uint8_t val)
+{
+    if(address < 0x04 || address == BUS_APU_STATUS)
+    {
+        current_channel = &channels[0];
+        write_reg_sq1(address, val);
+        dual_sync();
+    }
+
+    if((address >= 0x04 && address < 0x08) || address == BUS_APU_STATUS)
+    {
+        current_channel = &channels[1];
+        write_reg_sq2(address, val);
+        dual_sync();
+    }
+}
+
+void dual_frame_update(void)
+{
+    for(uint8_t i = 0; i < 2; i++)
+    {
+        current_channel = &channels[i];
+        frame_update_sq();
+        dual_sync();
+    }
+}
+
+void dual_init(void)
+{
+    for(uint16_t address = 0; address < 256; address++)
+    {
+        bus_filter[address] = address < BUS_APU + 0x08 || address == BUS_APU_STATUS || address == BUS_APU_FRAME;
+    }
+
+    set_outputs(PINS_DAC_B);
+    PINS_DAC_B_PORT &= ~PINS_DAC_B_MASK;
+
+    // Pulse 2 sweeps with the two's complement, see frame_update_sweep()
+    channels[0].conf = CHAN_SQ1;
+    channels[1].conf = CHAN_SQ2;
+
+    dual_volume0 = dual_volume1 = 0;
+    dual_duty_cycle0 = dual_duty_cycle1 = 0;
+    dual_step0 = dual_step1 = 0;
+    dual_interval0 = dual_interval1 = DUAL_MIN_INTERVAL;
+
+    dual_output0 = dual_output1 = 0;
+
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11); // Mode 0, running freely with prescaler 8
+    TIMSK1 = 0;         // channel_timer_start() enables the compare interrupts
+}
+
+
+#ifndef ASMINTERRUPT
+// Each writes the output computed by the previous sample first, as the
+// single channel interrupts do
+
+ISR(TIMER1_COMPA_vect) // Channel 0
+{
+    PINS_DAC_PORT = (PINS_DAC_PORT & ~PINS_DAC_MASK) | dual_output0;
+
+    OCR1A += dual_interval0;
+
+    dual_step0 = (dual_step0 + 1) & 0x0F;
+
+    dual_output0 = dual_step0 < dual_duty_cycle0 ? dual_volume0 : 0;
+}
+
+ISR(TIMER1_COMPB_vect) // Channel 1
+{
+    PINS_DAC_B_PORT = (PINS_DAC_B_PORT & ~PINS_DAC_B_MASK) | dual_output1;
+
+    OCR1B += dual_interval1;
+
+    dual_step1 = (dual_step1 + 1) & 0x0F;
+
+    dual_output1 = dual_step1 < dual_duty_cycle1 ? dual_volume1 : 0;
+}
+#endif
@@ -0,0 +1,11 @@
+#ifndef DUAL_H_
+#define DUAL_H_
+
+extern uint8_t bus_filter[256];
+
+void dual_init(void);
+
+void dual_write_reg(uint8_t address, uint8_t val);
+void dual_frame_update(void);
+
+#endif
@@ -7,111 +7,198 @@
         .section .text
 
 #ifdef ASMINTERRUPT
+#ifndef DUAL_CHANNEL
+        ;; One sample interrupt per channel type. read_conf() enables the
+        ;; one for the configured channel and sets timer 1 up for it, so
+        ;; none of them has to look at the configuration. The cycle counts
+        ;; include the 4 cycles to enter the interrupt and the rjmp in the
+        ;; vector table.
+        ;;
+        ;; Each of them starts by writing channel_output, the DAC nibble
+        ;; computed by the previous sample, and then computes the next one.
+        ;; The nibble is merged with the rest of PINS_DAC_PORT as it is at
+        ;; that moment, so the LED keeps what the main loop last set it to.
+        ;; The merge is the same for every channel, and the DAC changes 14
+        ;; cycles after the interrupt starts, whichever path the last sample
+        ;; took. It used to change after 19 cycles for the squares, 20 for
+        ;; the triangle and 17 to 46 for the noise, depending on whether a
+        ;; byte of the table was loaded. What is left is the latency of the
+        ;; interrupt itself: the instruction it has to wait for, and
+        ;; PCINT0_vect if it is running.
+
+        ;; Square: TIMER1_COMPA in CTC mode 4. 31 cycles.
+
         .global TIMER1_COMPA_vect
 TIMER1_COMPA_vect:
+        push    temp1                                ; 2
+        in      temp1, _SFR_IO_ADDR(SREG)            ; 1
+        push    temp1                                ; 2
+        in      temp1, _SFR_IO_ADDR(PINS_DAC_PORT)   ; 1
+        andi    temp1, ~PINS_DAC_MASK & 0xFF         ; 1
+        or      temp1, channel_output                ; 1
+        out     _SFR_IO_ADDR(PINS_DAC_PORT), temp1   ; 1
 
-        push    temp1
-        in      temp1, _SFR_IO_ADDR(SREG)
-        push    temp1
-
-        ;; Check MSB of config
-        sbis    _SFR_IO_ADDR(channel_conf), CONF1_BIT
-        rjmp    square
+        ;; if ((++channel_step & 0x0F) < channel_duty_cycle) output = vol; else output = 0;
+        inc     channel_step                         ; 1
+        mov     temp1, channel_step                  ; 1
+        andi    temp1, 0x0F                          ; 1
+        cp      temp1, channel_duty_cycle            ; 1
+        mov     channel_output, channel_volume       ; 1
+        brcs    1f                                   ; 1/2
+        clr     channel_output                       ; 1
+1:
+        pop     temp1                                ; 2
+        out     _SFR_IO_ADDR(SREG), temp1            ; 1
+        pop     temp1                                ; 2
+        reti                                         ; 4
 
-        ;; Check LSB of config
-not_square:
-        sbis    _SFR_IO_ADDR(channel_conf), CONF0_BIT
-        rjmp    triangle
+        ;; Triangle: TIMER1_COMPB with OCR1B = 0 in CTC mode 4. The 32 step
+        ;; wave is 15..0 followed by 0..15, which is the low nibble of the
+        ;; step, complemented in the first half. Only bits 0-4 of the step
+        ;; are used, so it doesn't need to wrap. frame_update_tri() stops
+        ;; the timer when either counter reaches zero. 30 cycles.
 
-noise:
-        mov     temp1, shift_register_lo             ; 1
-        bst     shift_register_lo, 6                 ; 1
-        sbis    _SFR_IO_ADDR(channel_shift_mode), SHIFT_MODE_BIT ; 2/1
-        bst     shift_register_lo, 1                 ; 1
-        ;; the first feedbackbit is now in T
+        .global TIMER1_COMPB_vect
+TIMER1_COMPB_vect:
+        push    temp1                                ; 2
+        in      temp1, _SFR_IO_ADDR(SREG)            ; 1
+        push    temp1                                ; 2
+        in      temp1, _SFR_IO_ADDR(PINS_DAC_PORT)   ; 1
+        andi    temp1, ~PINS_DAC_MASK & 0xFF         ; 1
+        or      temp1, channel_output                ; 1
+        out     _SFR_IO_ADDR(PINS_DAC_PORT), temp1   ; 1
 
-        ;; We don't need to zero temp2 first since we only care about bit 0
-        bld     temp2, 0                             ; 1
-        eor     temp1, temp2                         ; 1
+        inc     channel_step                         ; 1
+        mov     temp1, channel_step                  ; 1
+        sbrs    temp1, 4                             ; 2/1
+        com     temp1                                ; 1
+        andi    temp1, 0x0F                          ; 1
+        mov     channel_output, temp1                ; 1
 
-        bst     temp1, 0                             ; 1
-        bld     shift_register_hi, 7                 ; 1
+        pop     temp1                                ; 2
+        out     _SFR_IO_ADDR(SREG), temp1            ; 1
+        pop     temp1                                ; 2
+        reti                                         ; 4
 
-        lsr     shift_register_hi                    ; 1
-        ror     shift_register_lo                    ; 1
+        ;; Noise: TIMER1_CAPT in CTC mode 12, with the period in ICR1. The
+        ;; output of the shift register comes from noise_table.c, one bit of
+        ;; noise_bits per sample, with a set bit for silence. A byte holds
+        ;; seven bits below a sentinel bit, so noise_bits is zero once it has
+        ;; been used up, and a zero byte in the table marks its end.
+        ;;
+        ;; 29 cycles, and 47 when loading the next byte at every seventh
+        ;; sample, or 58 when going back to the start of the table.
+        ;; Clocking the shift register took 35 cycles every time.
 
+        .global TIMER1_CAPT_vect
+TIMER1_CAPT_vect:
+        push    temp1                                ; 2
+        in      temp1, _SFR_IO_ADDR(SREG)            ; 1
+        push    temp1                                ; 2
         in      temp1, _SFR_IO_ADDR(PINS_DAC_PORT)   ; 1
-        andi    temp1, 0xF0                          ; 1
-        sbrs    shift_register_lo, 0                 ; 2/1
-        or      temp1, channel_volume                ; 1
-                                                     ; 14 cycles
-
-output:
-        out      _SFR_IO_ADDR(PINS_DAC_PORT), temp1
-done:
-        pop     temp1
-        out     _SFR_IO_ADDR(SREG), temp1
-        pop     temp1
-        reti
+        andi    temp1, ~PINS_DAC_MASK & 0xFF         ; 1
+        or      temp1, channel_output                ; 1
+        out     _SFR_IO_ADDR(PINS_DAC_PORT), temp1   ; 1
 
-triangle:
-        and     channel_linear_counter, channel_linear_counter
-        breq    done
-        and     channel_length_counter, channel_length_counter
-        breq    done
+        lsr     noise_bits                           ; 1
+        breq    noise_load                           ; 1/2
+noise_output:
+        mov     channel_output, channel_volume       ; 1
+        brcc    1f                                   ; 1/2
+        clr     channel_output                       ; 1
+1:
+        pop     temp1                                ; 2
+        out     _SFR_IO_ADDR(SREG), temp1            ; 1
+        pop     temp1                                ; 2
+        reti                                         ; 4
 
-        mov     temp1, channel_step                  ; 1
-        inc     temp1                                ; 1
-        andi    temp1, 0x1F                          ; 1
-        mov     channel_step, temp1                  ; 1
+noise_load:
         push    r30                                  ; 2
         push    r31                                  ; 2
-        ;; We can shorten this if we align wave_buf to a 256 (or 32) byte boundary
-        ;;  ldi     r31, hi8(wave_buf)
-        ;;  mov     r30, channel_step
-        ;; or
-        ;;  ldi     r31, hi8(wave_buf)
-        ;;  ldi     r30, lo8(wave_buf)
-        ;;  add     r30, channel_step
-
-        ldi     r30, lo8(wave_buf)                   ; 1
-        ldi     r31, hi8(wave_buf)                   ; 1
-        add     r30, channel_step                    ; 1
-        adc     r31, r1                              ; 1
-        ld      temp1, Z                             ; 2
+        movw    r30, noise_ptr_lo                    ; 1
+        lpm     noise_bits, Z+                       ; 3
+        lsr     noise_bits                           ; 1
+        breq    noise_wrap                           ; 1/2
+noise_loaded:
+        movw    noise_ptr_lo, r30                    ; 1
         pop     r31                                  ; 2
         pop     r30                                  ; 2
+        rjmp    noise_output                         ; 2
 
-        andi    temp1, 0x0F                          ; 1
+noise_wrap:
+        lds     r30, noise_start                     ; 2
+        lds     r31, noise_start+1                   ; 2
+        lpm     noise_bits, Z+                       ; 3
+        lsr     noise_bits                           ; 1
+        rjmp    noise_loaded                         ; 2
 
-        ;; Add a two bit volume to the triangle channel
-        ;;  sbic    _SFR_IO_ADDR(GPIOR0), VOL_BIT1       ; 1/2
-        ;;  lsr     temp1                                ; 1
-        ;;  sbic    _SFR_IO_ADDR(GPIOR0), VOL_BIT1       ; 1/2
-        ;;  lsr     temp1                                ; 1
-        ;;  sbic    _SFR_IO_ADDR(GPIOR0), VOL_BIT0       ; 1/2
-        ;;  lsr     temp1                                ; 1
+#else
+        ;; Dual channel firmware, see dual.c. Timer 1 runs freely and each
+        ;; square moves its compare value on by its interval, writing the
+        ;; DAC nibble computed by the previous sample first, merged with the
+        ;; rest of its port as above. The interrupts of the two channels
+        ;; can't interrupt each other, so SREG is kept in dual_sreg. 37
+        ;; cycles each.
 
-        mov     temp2, temp1                         ; 1
+        .global TIMER1_COMPA_vect
+TIMER1_COMPA_vect:
+        in      dual_sreg, _SFR_IO_ADDR(SREG)        ; 1
+        push    temp1                                ; 2
         in      temp1, _SFR_IO_ADDR(PINS_DAC_PORT)   ; 1
-        andi    temp1, 0xF0                          ; 1
-        or      temp1, temp2                         ; 1
-        rjmp    output
+        andi    temp1, ~PINS_DAC_MASK & 0xFF         ; 1
+        or      temp1, dual_output0                  ; 1
+        out     _SFR_IO_ADDR(PINS_DAC_PORT), temp1   ; 1
 
-square:
-        ;; channel_step = (channel_step + 1) & 0x0F
-        mov     temp1, channel_step
-        subi    temp1, 0xFF
-        andi    temp1, 0x0F
-        mov     channel_step, temp1
+        ;; OCR1A += dual_interval0, low byte first when reading and high
+        ;; byte first when writing
+        lds     temp1, OCR1AL                        ; 2
+        lds     temp2, OCR1AH                        ; 2
+        add     temp1, dual_interval0_lo             ; 1
+        adc     temp2, dual_interval0_hi             ; 1
+        sts     OCR1AH, temp2                        ; 2
+        sts     OCR1AL, temp1                        ; 2
 
-        ;; if (channel_step < channel_duty_cycle) output = vol; else output = 0;
-        cp      temp1, channel_duty_cycle
-        in      temp1, _SFR_IO_ADDR(PINS_DAC_PORT)
-        andi    temp1, 0xF0
-        brcc    output
-        or      temp1, channel_volume
-        rjmp    output
+        inc     dual_step0                           ; 1
+        mov     temp1, dual_step0                    ; 1
+        andi    temp1, 0x0F                          ; 1
+        cp      temp1, dual_duty_cycle0              ; 1
+        mov     dual_output0, dual_volume0           ; 1
+        brcs    1f                                   ; 1/2
+        clr     dual_output0                         ; 1
+1:
+        pop     temp1                                ; 2
+        out     _SFR_IO_ADDR(SREG), dual_sreg        ; 1
+        reti                                         ; 4
+
+        .global TIMER1_COMPB_vect
+TIMER1_COMPB_vect:
+        in      dual_sreg, _SFR_IO_ADDR(SREG)        ; 1
+        push    temp1                                ; 2
+        in      temp1, _SFR_IO_ADDR(PINS_DAC_B_PORT) ; 1
+        andi    temp1, ~PINS_DAC_B_MASK & 0xFF       ; 1
+        or      temp1, dual_output1                  ; 1
+        out     _SFR_IO_ADDR(PINS_DAC_B_PORT), temp1 ; 1
+
+        lds     temp1, OCR1BL                        ; 2
+        lds     temp2, OCR1BH                        ; 2
+        add     temp1, dual_interval1_lo             ; 1
+        adc     temp2, dual_interval1_hi             ; 1
+        sts     OCR1BH, temp2                        ; 2
+        sts     OCR1BL, temp1                        ; 2
+
+        inc     dual_step1                           ; 1
+        mov     temp1, dual_step1                    ; 1
+        andi    temp1, 0x0F                          ; 1
+        cp      temp1, dual_duty_cycle1              ; 1
+        mov     dual_output1, dual_volume1           ; 1
+        brcs    1f                                   ; 1/2
+        clr     dual_output1                         ; 1
+1:
+        pop     temp1                                ; 2
+        out     _SFR_IO_ADDR(SREG), dual_sreg        ; 1
+        reti                                         ; 4
+
+#endif
 
 
 
@@ -121,3 +208,82 @@ PCINT1_vect:
         reti
 
 #endif
+
+
+
+        ;; Bus receive. Every edge of DCLK latches one byte into bus_buf: an
+        ;; address on the rising edge and its value on the falling edge. The
+        ;; controller only holds the bus for a few microseconds, so sample it
+        ;; first. Nothing changes SREG except counting an overflow.
+        ;;
+        ;; Only the registers of this board are kept, the addresses set in
+        ;; bus_filter by read_conf() or dual_init(). The value of a dropped
+        ;; address is dropped as well, which BUS_DROP_BIT keeps track of.
+        ;;
+        ;; A value arriving at an even offset has lost its address, and is
+        ;; dropped. An address arriving at an odd offset replaces the one
+        ;; that lost its value. Both set BUS_ERROR_BIT. So does a full
+        ;; buffer, which drops the byte and counts it in bus_overflows.
+
+        .global PCINT0_vect
+PCINT0_vect:
+        in      temp2, _SFR_IO_ADDR(PINS_BUS_PIN)    ; 1
+        push    r30                                  ; 2
+        push    r31                                  ; 2
+
+        sbis    _SFR_IO_ADDR(PIN_DCLK_PIN), PIN_DCLK ; 2/1
+        rjmp    bus_value                            ; 2
+
+bus_address:
+        ldi     r31, hi8(bus_filter)                 ; 1
+        mov     r30, temp2                           ; 1
+        ld      r30, Z                               ; 2
+        sbrs    r30, 0                               ; 2/1
+        rjmp    bus_drop                             ; 2
+
+bus_address_keep:
+        cbi     _SFR_IO_ADDR(bus_error_flag), BUS_DROP_BIT ; 2
+        ldi     r31, hi8(bus_buf)                    ; 1
+        in      r30, _SFR_IO_ADDR(bus_head)          ; 1
+        sbrc    r30, 0                               ; 2/1
+        sbi     _SFR_IO_ADDR(bus_error_flag), BUS_ERROR_BIT ; 2
+        sbrc    r30, 0                               ; 2/1
+        st      -Z, temp2                            ; 2
+
+bus_store:
+        ;; Only the low byte of Z is kept, so the offset wraps within the page
+        st      Z+, temp2                            ; 2
+        lds     r31, bus_tail                        ; 2
+        cpse    r30, r31                             ; 1/2
+        rjmp    bus_publish                          ; 2
+
+        ;; The byte went into the slot before the tail, which has been read
+        ;; already, but the head can't move onto the tail
+        in      temp2, _SFR_IO_ADDR(SREG)
+        lds     r31, bus_overflows
+        inc     r31
+        sts     bus_overflows, r31
+        out     _SFR_IO_ADDR(SREG), temp2
+        sbi     _SFR_IO_ADDR(bus_error_flag), BUS_ERROR_BIT
+        rjmp    bus_done
+
+bus_publish:
+        out     _SFR_IO_ADDR(bus_head), r30          ; 1
+bus_done:
+        pop     r31                                  ; 2
+        pop     r30                                  ; 2
+        reti                                         ; 45 cycles at most for a kept address, 37 for a value
+
+bus_drop:
+        sbi     _SFR_IO_ADDR(bus_error_flag), BUS_DROP_BIT
+        rjmp    bus_done
+
+bus_value:
+        sbic    _SFR_IO_ADDR(bus_error_flag), BUS_DROP_BIT ; 2/1
+        rjmp    bus_done                             ; 2
+        ldi     r31, hi8(bus_buf)                    ; 1
+        in      r30, _SFR_IO_ADDR(bus_head)          ; 1
+        sbrc    r30, 0                               ; 2/1
+        rjmp    bus_store                            ; 2
+        sbi     _SFR_IO_ADDR(bus_error_flag), BUS_ERROR_BIT
+        rjmp    bus_done
@@ -2,6 +2,8 @@
 #include <util/delay.h>
 #include <avr/interrupt.h>
 #include <avr/sleep.h>
+#include <avr/pgmspace.h>
+#include <avr/eeprom.h>
 
 
 #include <stdlib.h>
@@ -12,26 +14,27 @@
 
 #include "io.h"
 
-#include "cbuf.h"
-
 #include "nes_apu_channel.h"
 
-#define reg_address_LEN 32
-#define reg_data_LEN 32
+#ifdef DUAL_CHANNEL
+#include "dual.h"
+#else
+#include "board.h"
+#endif
 
-struct
-{
-    volatile uint8_t head;
-    volatile uint8_t tail;
-    volatile uint8_t buf[reg_address_LEN];
-} reg_address;
+// Writes to the registers of this channel from the bus, written by
+// PCINT0_vect in interrupt.asm: addresses at even and values at odd offsets.
+// The buffer fills a whole 256 byte aligned page so that the interrupt can
+// wrap the offset without touching SREG. The head is kept in GPIOR1.
+volatile uint8_t bus_buf[256] __attribute__ ((aligned (0x100)));
+volatile uint8_t bus_tail;
 
-struct
-{
-    volatile uint8_t head;
-    volatile uint8_t tail;
-    volatile uint8_t buf[reg_data_LEN];
-} reg_data;
+// Bytes dropped because bus_buf was full, for diagnostics
+volatile uint8_t bus_overflows;
+
+// Non-zero for the addresses that this board keeps, looked up by
+// PCINT0_vect. A page of its own for the same reason as bus_buf.
+uint8_t bus_filter[256] __attribute__ ((aligned (0x100)));
 
 
 #if 0
@@ -69,7 +72,7 @@ void timers_init()
 {
     TCCR1A = 0;
     TCCR1B = _BV(WGM12);  // Mode 4, CTC on OCR1A
-    TIMSK1 = _BV(OCIE1A); // Set interrupt on compare match
+    TIMSK1 = 0;           // read_conf() enables the interrupt of the channel
 }
 
 void interrupts_init()
@@ -79,54 +82,46 @@ void interrupts_init()
     PCMSK1 = _BV(PCINT13); // Enable FCLK interrupt
 }
 
-void read_conf()
+#ifndef DUAL_CHANNEL
+// Returns the board ID, see board.h
+uint8_t read_conf()
 {
-    uint8_t conf = (is_high(PIN_CONF1) ? 2 : 0) | (is_high(PIN_CONF0) ? 1 : 0);
+    uint8_t id = eeprom_read_byte((const uint8_t*)BOARD_ID_EEPROM_ADDR);
 
-    channel_conf = (channel_conf & ~(_BV(CONF0_BIT) | _BV(CONF1_BIT))) | (is_high(PIN_CONF0) ? _BV(CONF0_BIT) : 0) | (is_high(PIN_CONF1) ? _BV(CONF1_BIT) : 0);
+    if(id >= NUM_BOARDS)
+    {
+        id = (is_high(PIN_CONF1) ? 2 : 0) | (is_high(PIN_CONF0) ? 1 : 0);
+    }
 
-    switch(conf)
+    // frame_update_sweep() tells the squares apart by CONF0
+    channel_conf = (channel_conf & ~(_BV(CONF0_BIT) | _BV(CONF1_BIT))) | ((id & 1) ? _BV(CONF0_BIT) : 0) | ((id & 2) ? _BV(CONF1_BIT) : 0);
+
+    const board_t *board = &boards[id];
+
+    for(uint16_t address = 0; address < 256; address++)
     {
-    case CHAN_SQ1:
-        write_reg = write_reg_sq1;
-        frame_update = frame_update_sq;
-        break;
-
-    case CHAN_SQ2:
-        write_reg = write_reg_sq2;
-        frame_update = frame_update_sq;
-        break;
-
-    case CHAN_TRI:
-        write_reg = write_reg_tri;
-        frame_update = frame_update_tri;
-        break;
-
-    case CHAN_NOISE:
-    default:
-        write_reg = write_reg_noise;
-        frame_update = frame_update_noise;
-
-        channel_volume = 0;
-
-        shift_register_hi = 0;
-        shift_register_lo = 1;
-        break;
+        bus_filter[address] = board->keeps(address);
     }
+
+    write_reg = board->write_reg;
+    frame_update = board->frame_update;
+
+    board->init();
+
+    return id;
 }
 
-void blink_conf()
+void blink_conf(uint8_t id)
 {
-    uint8_t conf = (is_high(PIN_CONF1) ? 2 : 0) | (is_high(PIN_CONF0) ? 1 : 0);
-
     do
     {
         set_high(PIN_LED);
         _delay_ms(125);
         set_low(PIN_LED);
         _delay_ms(250);
-    } while(conf--);
+    } while(id--);
 }
+#endif
 
 int main()
 {
@@ -134,27 +129,43 @@ int main()
     timers_init();
     interrupts_init();
 
-    cbuf_init(reg_address);
-    cbuf_init(reg_data);
+    bus_head = bus_tail = 0;
 
-    read_conf();
+#ifdef DUAL_CHANNEL
+    dual_init();
+    write_reg = dual_write_reg;
+    frame_update = dual_frame_update;
 
     sei();
+#else
+    channel_output = 0;
+
+    uint8_t id = read_conf();
 
-    blink_conf();
+    sei();
+
+    blink_conf(id);
+#endif
 
     for(;;)
     {
-        while(!cbuf_empty(reg_data))
+        while((uint8_t)(bus_head - bus_tail) >= 2)
         {
-            uint8_t address = cbuf_pop(reg_address);
-            uint8_t val = cbuf_pop(reg_data);
+            uint8_t address = bus_buf[bus_tail++];
+            uint8_t val = bus_buf[bus_tail++];
+
+            set_high(PIN_LED);
 
             // TODO: Handle 0x4017 to change frame counter mode
             write_reg(address, val);
         }
 
-        set_low(PIN_LED);
+        // The LED stays on after a lost bus edge or an overflow, until the
+        // channel is reset. The controller's bus calibration relies on this.
+        if(!(bus_error_flag & _BV(BUS_ERROR_BIT)))
+        {
+            set_low(PIN_LED);
+        }
 
         if(frame_flag & _BV(FRAME_FLAG_BIT))
         {
@@ -167,73 +178,69 @@ int main()
 
 
 #ifndef ASMINTERRUPT
-ISR(TIMER1_COMPA_vect)
+#ifndef DUAL_CHANNEL
+// One sample interrupt per channel type, see read_conf(). Each writes the
+// output computed by the previous sample first, so that the DAC changes at
+// the same time after the interrupt whatever the previous sample did. Only
+// the DAC pins are written, the LED belongs to the main loop.
+
+ISR(TIMER1_COMPA_vect) // Square
 {
-    set_high(PIN_LED);
+    PINS_DAC_PORT = (PINS_DAC_PORT & ~PINS_DAC_MASK) | channel_output;
 
-    if(!(channel_conf & _BV(CONF1_BIT)))
+    channel_step = (channel_step+1) & 0x0F;
+
+    uint8_t val = 0;
+
+    if(channel_step < channel_duty_cycle)
     {
-        // case CHAN_SQ1:
-        // case CHAN_SQ2:
+        val = channel_volume;
+    }
 
-        channel_step = (channel_step+1) & 0x0F;
+    channel_output = val;
+}
 
-        if(channel_step < channel_duty_cycle)
-        {
-            PINS_DAC_PORT |= channel_volume;
-        } else {
-            PINS_DAC_PORT &= 0xF0;
-        }
-    } else {
-        if(!(channel_conf & _BV(CONF0_BIT)))
+ISR(TIMER1_COMPB_vect) // Triangle
+{
+    PINS_DAC_PORT = (PINS_DAC_PORT & ~PINS_DAC_MASK) | channel_output;
+
+    channel_step = (channel_step + 1) & 0x1F;
+
+    uint8_t val = channel_step;
+
+    if(channel_step & 0x10)
+    {
+        val = ~channel_step;
+    }
+
+    channel_output = val & 0x0F;
+}
+
+ISR(TIMER1_CAPT_vect) // Noise
+{
+    PINS_DAC_PORT = (PINS_DAC_PORT & ~PINS_DAC_MASK) | channel_output;
+
+    uint8_t silent = noise_bits & 0x01;
+    noise_bits >>= 1;
+
+    if(!noise_bits)
+    {
+        // Only the sentinel bit was left
+        noise_bits = pgm_read_byte(noise_ptr++);
+
+        if(!noise_bits)
         {
-            // case CHAN_TRI:
-            if((channel_linear_counter > 0) && (channel_length_counter > 0))
-            {
-                channel_step = (channel_step + 1) & 0x1F;
-
-                uint8_t val = channel_step;
-
-                if(channel_step & 0x10)
-                {
-                    val = ~channel_step;
-                }
-
-                PINS_DAC_PORT = (PINS_DAC_PORT & 0xF0) | (val & 0x0F);
-            }
-        } else {
-            // case CHAN_NOISE:
-            uint8_t feedback;
-
-            if(channel_shift_mode & _BV(SHIFT_MODE_BIT))
-            {
-                feedback = ((shift_register_lo & _BV(0)) ^ ((shift_register_lo & _BV(6)) >> 6));
-            } else {
-                feedback = ((shift_register_lo & _BV(0)) ^ ((shift_register_lo & _BV(1)) >> 1));
-            }
-
-            // 16-bit shift right
-            asm volatile(
-                "lsr %0\t\n"
-                "ror %1\t\n"
-                : "=&r" (shift_register_hi), "=&r" (shift_register_lo):);
-
-            if(feedback)
-            {
-                shift_register_hi |= 0x40;
-            }
-
-            if(!(shift_register_lo & _BV(0)))
-            {
-                PINS_DAC_PORT |= channel_volume;
-            } else {
-                PINS_DAC_PORT &= 0xF0;
-            }
+            noise_ptr = noise_start;
+            noise_bits = pgm_read_byte(noise_ptr++);
         }
+
+        silent = noise_bits & 0x01;
+        noise_bits >>= 1;
     }
 
-    set_low(PIN_LED);
+    channel_output = silent ? 0 : channel_volume;
 }
+#endif
 
 ISR(PCINT1_vect)
 {
@@ -241,16 +248,3 @@ ISR(PCINT1_vect)
 }
 
 #endif
-
-// High: address, Low: data
-
-ISR(PCINT0_vect)
-{
-    if(is_high(PIN_DCLK))
-    {
-        cbuf_push(reg_address, PINS_BUS_PIN);
-    } else {
-        cbuf_push(reg_data, PINS_BUS_PIN);
-    }
-    set_high(PIN_LED);
-}
@@ -1,14 +1,17 @@
 #ifdef AVR
 #include <avr/io.h>
-#else
-#include <stdio.h>
+#include <avr/pgmspace.h>
+#include <avr/interrupt.h>
 #endif
 
 #include <stdlib.h>
 #include <stddef.h>
 #include <stdint.h>
 
-#ifdef AVR
+#include "config.h"
+#include "nes_apu_channel.h"
+
+#if CHANNEL_IN_REGISTERS
 #include "registers.h"
 #else
 #define channel_shift_mode     channel.shift_mode
@@ -19,30 +22,53 @@
 #define channel_linear_counter channel.linear_counter
 #endif
 
-#include "config.h"
-#include "nes_apu_channel.h"
+#if CHANNEL_IN_REGISTERS
+#include "noise_table.h"
+#endif
 
-#ifdef AVR
+#if CHANNEL_IN_REGISTERS
 #define channel_timer_start() do { TCCR1B |=  _BV(CS11); } while(0)
 #define channel_timer_stop()  do { TCCR1B &= ~_BV(CS11); } while(0)
 #define channel_timer_set_period(p) do { OCR1A = p; } while(0)
+// The noise channel runs timer 1 with ICR1 as TOP, see read_conf()
+#define noise_timer_set_period(p) do { ICR1 = p; } while(0)
+#else
+#define noise_timer_set_period(p) channel_timer_set_period(p)
+#ifdef AVR
+#define noise_set_mode(short_mode) do { } while(0)
+#else
+// The host clocks the shift register itself, restarting from power up
+#define noise_set_mode(short_mode) do { channel.shift_register = 1; } while(0)
+#endif
 #endif
-
-volatile uint8_t wave_buf[32] __attribute__ ((aligned (0x100))) = {
-    0xF, 0xE, 0xD, 0xC, 0xB, 0xA, 0x9, 0x8, 0x7, 0x6, 0x5, 0x4, 0x3, 0x2, 0x1, 0x0,
-    0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF
-};
 
 channel_t channel;
 
+#if CHANNEL_IN_REGISTERS
+// Where the noise interrupt starts again after the end of the table
+const uint8_t *noise_start;
+
+// Switching modes starts the other sequence from the beginning, instead of
+// carrying the state of the shift register over
+void noise_set_mode(uint8_t short_mode)
+{
+    uint8_t sreg = SREG;
+    cli();
+
+    noise_start = noise_ptr = short_mode ? noise_table_short : noise_table_long;
+    noise_bits = 0; // Load a byte at the next sample
+
+    SREG = sreg;
+}
+#endif
+
 static const uint8_t length_lut[32] = {
     10, 254, 20,  2, 40,  4, 80,  6, 160,  8, 60, 10, 14, 12, 26, 14,
     12,  16, 24, 18, 48, 20, 96, 22, 192, 24, 72, 26, 16, 28, 32, 30
 };
 
-// Note: the lowest value is made a bit larger in order for the interrupt to have time to fire
 static const uint16_t noise_period_lut[16] = {
-    0x008, 0x008, 0x010, 0x020, 0x040, 0x060, 0x080, 0x0a0,
+    0x004, 0x008, 0x010, 0x020, 0x040, 0x060, 0x080, 0x0a0,
     0x0ca, 0x0fe, 0x17c, 0x1fc, 0x2fa, 0x3f8, 0x7f2, 0xfe4
 };
 
@@ -71,6 +97,15 @@ static const uint8_t duty_tab[4] = {2, 4, 8, 12};
         }                                                               \
     } while(0)
 
+#define CHECK_MUTE_VRC6_PULSE() do {                                    \
+        if((channel.period < 8) || !channel.enabled)                    \
+        {                                                               \
+            channel_timer_stop();                                       \
+        } else {                                                        \
+            channel_timer_start();                                      \
+        }                                                               \
+    } while(0)
+
 #define CHECK_MUTE_NOISE() do {                                         \
         if((channel.period < 4) || !channel_length_counter)             \
         {                                                               \
@@ -274,16 +309,18 @@ void write_reg_noise(uint8_t address, uint8_t val)
           7   mode
          */
 
-        if(val & 0x80)
+        if((val & 0x80) && !(channel_shift_mode & _BV(SHIFT_MODE_BIT)))
         {
             channel_shift_mode |= _BV(SHIFT_MODE_BIT);
-        } else {
+            noise_set_mode(1);
+        } else if(!(val & 0x80) && (channel_shift_mode & _BV(SHIFT_MODE_BIT))) {
             channel_shift_mode &= ~_BV(SHIFT_MODE_BIT);
+            noise_set_mode(0);
         }
 
         channel.period = noise_period_lut[val & 0x0F];
 
-        channel_timer_set_period(channel.period+1);
+        noise_timer_set_period(channel.period+1);
 
         channel_timer_start(); // ???
         break;
@@ -307,6 +344,42 @@ void write_reg_noise(uint8_t address, uint8_t val)
     CHECK_MUTE_NOISE();
 }
 
+void write_reg_vrc6_pulse(uint8_t address, uint8_t val)
+{
+    switch(address & 0x03)
+    {
+    case 0x00: // $9000, $A000
+        /*
+          0-3   volume
+          4-6   duty cycle, on for duty + 1 of 16 steps
+          7     mode, on for every step
+        */
+        channel_volume = val & 0x0F;
+        channel_duty_cycle = (val & 0x80) ? 16 : ((val >> 4) & 0x07) + 1;
+        break;
+
+    case 0x01: // $9001, $A001
+        /*
+          0-7   8 LSB of wavelength
+        */
+        channel.period_lo = val;
+        channel_timer_set_period(channel.period+1);
+        break;
+
+    case 0x02: // $9002, $A002
+        /*
+          0-3   4 MS bits of wavelength
+          7     enable
+        */
+        channel.period_hi = val & 0x0F;
+        channel.enabled = val & 0x80;
+        channel_timer_set_period(channel.period+1);
+        break;
+    }
+
+    CHECK_MUTE_VRC6_PULSE();
+}
+
 static void frame_update_length_counter()
 {
     if(!channel.length_counter_halt_flag && channel_length_counter > 0)
@@ -336,7 +409,6 @@ static void frame_update_sweep()
 
 
             const uint16_t sweep_target_period = channel.period + delta;
-            printf("%d\n", sweep_target_period);
             if(sweep_target_period < 0x800) {
                 channel_timer_set_period(sweep_target_period+1);
             }
@@ -437,4 +509,12 @@ void frame_update_tri()
     {
         channel.linear_counter_reload_flag = 0;
     }
+
+    // The sample interrupt doesn't check the counters itself
+    CHECK_MUTE_TRI();
+}
+
+// The VRC6 has no length counters, envelopes or sweeps
+void frame_update_vrc6_pulse()
+{
 }
@@ -6,6 +6,15 @@
 #define CHAN_TRI   2
 #define CHAN_NOISE 3
 
+// The single channel firmware keeps what the sample interrupt needs in
+// registers, see registers.h. The dual channel firmware and the host keep it
+// in channel_t, one for each channel.
+#if defined(AVR) && !defined(DUAL_CHANNEL)
+#define CHANNEL_IN_REGISTERS 1
+#else
+#define CHANNEL_IN_REGISTERS 0
+#endif
+
 typedef struct
 {
     union
@@ -21,7 +30,7 @@ typedef struct
     volatile uint8_t enabled;                // Square + Noise + Triangle
     uint8_t length_counter_halt_flag;        // Square + Noise + Triangle
 
-#ifndef AVR // moved to register
+#if !CHANNEL_IN_REGISTERS // moved to register
     volatile uint8_t length_counter;         // Square + Noise + Triangle
 
     union {
@@ -44,7 +53,7 @@ typedef struct
     uint8_t env_divider;                     // Square + Noise
     uint8_t env_volume;                      // Square + Noise
 
-#ifndef AVR // moved to register & GPIOR0
+#if !CHANNEL_IN_REGISTERS // moved to register & GPIOR0
     union {
         volatile uint8_t duty_cycle;         // Square
         volatile uint8_t shift_mode;         // Noise
@@ -64,8 +73,11 @@ typedef struct
 
     uint8_t frame_counter;
 
-#ifndef AVR
+#if !CHANNEL_IN_REGISTERS
     uint8_t conf;
+#endif
+
+#ifndef AVR
     uint8_t step;
     uint8_t muted;
     uint16_t reload_period;
@@ -73,13 +85,17 @@ typedef struct
 #endif
 } channel_t;
 
-extern volatile uint8_t wave_buf[32] __attribute__ ((aligned (0x100)));
-
-#ifndef AVR
+#if !CHANNEL_IN_REGISTERS
 extern channel_t *current_channel;
 #define channel (*current_channel)
 #endif
 
+#if CHANNEL_IN_REGISTERS
+extern const uint8_t *noise_start;
+
+void noise_set_mode(uint8_t short_mode);
+#endif
+
 void write_reg_sq1(uint8_t address, uint8_t val);
 void write_reg_sq2(uint8_t address, uint8_t val);
 void write_reg_tri(uint8_t address, uint8_t val);
@@ -89,11 +105,17 @@ void frame_update_sq(void);
 void frame_update_tri(void);
 void frame_update_noise(void);
 
-#ifndef AVR
+// Either pulse of the VRC6, at BUS_VRC6_PULSE1 or BUS_VRC6_PULSE2
+void write_reg_vrc6_pulse(uint8_t address, uint8_t val);
+void frame_update_vrc6_pulse(void);
+
+#if !CHANNEL_IN_REGISTERS
 void channel_timer_start(void);
 void channel_timer_stop(void);
 void channel_timer_set_period(uint16_t period);
+#endif
 
+#ifndef AVR
 #define _BV(n) (1u << (n))
 #endif
 
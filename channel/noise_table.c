@@ -0,0 +1,313 @@
+// Generated by scripts/make_noise_table
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+#include "noise_table.h"
+
+const uint8_t noise_table_long[4682] PROGMEM = {
+    0x80, 0x80, 0x81, 0x80, 0x83, 0x80, 0x85, 0x80, 0x8F, 0x80, 0x91, 0x80, 0xB3, 0x80, 0xD5, 0x80,
+    0xFF, 0x81, 0x81, 0x82, 0x83, 0x86, 0x85, 0x8A, 0x8F, 0x9E, 0x91, 0xA2, 0xB3, 0xE6, 0xD5, 0xAA,
+    0xFE, 0xFF, 0x82, 0x80, 0x87, 0x80, 0x89, 0x80, 0x9B, 0x80, 0xAD, 0x80, 0xF7, 0x80, 0x99, 0x81,
+    0xAB, 0x83, 0xFD, 0x85, 0x87, 0x8E, 0x89, 0x92, 0x9B, 0xB6, 0xAD, 0xDA, 0xF7, 0xEE, 0x98, 0xB3,
+    0xA9, 0xD5, 0xFB, 0xFF, 0x8C, 0x80, 0x95, 0x80, 0xBF, 0x80, 0xC1, 0x80, 0xC3, 0x81, 0xC5, 0x82,
+    0xCF, 0x87, 0xD1, 0x88, 0xF3, 0x99, 0x95, 0xAA, 0xBF, 0xFE, 0xC1, 0x82, 0xC2, 0x87, 0xC6, 0x88,
+    0xCA, 0x99, 0xDE, 0xAA, 0xE2, 0xFF, 0xA6, 0x80, 0xEB, 0x80, 0xBD, 0x81, 0xC7, 0x83, 0xC9, 0x84,
+    0xDB, 0x8D, 0xED, 0x96, 0xB7, 0xBB, 0xD9, 0xCD, 0xEB, 0xD6, 0xBC, 0xFB, 0xC5, 0x8D, 0xCE, 0x96,
+    0xD2, 0xBB, 0xF6, 0xCC, 0x9A, 0xD5, 0xAF, 0xFF, 0xF0, 0x81, 0x91, 0x82, 0xB3, 0x86, 0xD5, 0x8A,
+    0xFF, 0x9F, 0x81, 0xA0, 0x83, 0xE0, 0x85, 0xA0, 0x8E, 0xE0, 0x92, 0xA0, 0xB7, 0xE0, 0xD9, 0xA0,
+    0xEA, 0xE1, 0xBE, 0xA2, 0xC3, 0xE6, 0xC5, 0xAB, 0xCE, 0xFC, 0xD2, 0x85, 0xF7, 0x8E, 0x99, 0x93,
+    0xAB, 0xB5, 0xFD, 0xDF, 0x87, 0xE0, 0x88, 0xA0, 0x99, 0xE0, 0xAB, 0xA0, 0xFC, 0xE0, 0x84, 0xA1,
+    0x8D, 0xE3, 0x97, 0xA5, 0xB8, 0xEF, 0xC8, 0xB1, 0xD9, 0xD2, 0xEB, 0xF7, 0xBC, 0x98, 0xC5, 0xA8,
+    0xCF, 0xF9, 0xD1, 0x8A, 0xF2, 0x9F, 0x96, 0xA0, 0xBA, 0xE0, 0xCE, 0xA0, 0xD3, 0xE1, 0xF5, 0xA2,
+    0x9E, 0xE7, 0xA2, 0xA9, 0xE7, 0xFB, 0xA9, 0x8C, 0xFA, 0x94, 0x8E, 0xBD, 0x92, 0xC7, 0xB6, 0xC9,
+    0xDB, 0xDB, 0xEC, 0xEC, 0xB5, 0xB5, 0xDE, 0xDF, 0xE2, 0xE0, 0xA7, 0xA1, 0xE8, 0xE3, 0xB8, 0xA4,
+    0xC9, 0xEC, 0xDB, 0xB5, 0xEC, 0xDE, 0xB4, 0xE3, 0xDD, 0xA5, 0xE6, 0xEE, 0xAA, 0xB3, 0xFF, 0xD5,
+    0x81, 0xFE, 0x82, 0x82, 0x87, 0x86, 0x89, 0x8A, 0x9B, 0x9E, 0xAD, 0xA2, 0xF7, 0xE6, 0x99, 0xAB,
+    0xAA, 0xFD, 0xFE, 0x87, 0x83, 0x88, 0x85, 0x98, 0x8F, 0xA8, 0x91, 0xF8, 0xB3, 0x88, 0xD4, 0x98,
+    0xFC, 0xA9, 0x84, 0xFA, 0x8C, 0x8E, 0x95, 0x92, 0xBF, 0xB6, 0xC1, 0xDA, 0xC3, 0xEF, 0xC4, 0xB0,
+    0xCD, 0xD1, 0xD7, 0xF2, 0xF8, 0x97, 0x89, 0xB8, 0x9B, 0xC8, 0xAD, 0xD8, 0xF6, 0xE8, 0x9B, 0xB9,
+    0xAC, 0xCB, 0xF4, 0xDD, 0x9D, 0xE6, 0xA6, 0xAA, 0xEB, 0xFE, 0xBD, 0x83, 0xC6, 0x85, 0xCA, 0x8E,
+    0xDE, 0x93, 0xE2, 0xB4, 0xA6, 0xDD, 0xEA, 0xE7, 0xBF, 0xA8, 0xC0, 0xF8, 0xC0, 0x89, 0xC1, 0x9A,
+    0xC3, 0xAF, 0xC5, 0xF0, 0xCF, 0x91, 0xD0, 0xB2, 0xF0, 0xD7, 0x90, 0xF8, 0xB1, 0x88, 0xD2, 0x98,
+    0xF6, 0xA9, 0x9A, 0xFA, 0xAE, 0x8E, 0xF3, 0x92, 0x95, 0xB7, 0xBF, 0xD9, 0xC1, 0xEB, 0xC2, 0xBC,
+    0xC7, 0xC5, 0xC9, 0xCE, 0xDA, 0xD3, 0xEF, 0xF4, 0xB0, 0x9D, 0xD1, 0xA7, 0xF3, 0xE8, 0x95, 0xB9,
+    0xBE, 0xCB, 0xC2, 0xDD, 0xC7, 0xE6, 0xC8, 0xAB, 0xD9, 0xFC, 0xEB, 0x85, 0xBC, 0x8E, 0xC4, 0x92,
+    0xCC, 0xB7, 0xD4, 0xD8, 0xFC, 0xE9, 0x85, 0xBA, 0x8E, 0xCE, 0x92, 0xD2, 0xB7, 0xF6, 0xD8, 0x9A,
+    0xE9, 0xAF, 0xBB, 0xF0, 0xCD, 0x90, 0xD6, 0xB1, 0xFA, 0xD2, 0x8E, 0xF7, 0x93, 0x99, 0xB4, 0xAB,
+    0xDC, 0xFD, 0xE4, 0x86, 0xAD, 0x8B, 0xF7, 0x9D, 0x99, 0xA6, 0xAB, 0xEA, 0xFD, 0xBE, 0x86, 0xC3,
+    0x8A, 0xC5, 0x9F, 0xCF, 0xA0, 0xD1, 0xE1, 0xF3, 0xA2, 0x94, 0xE7, 0xBC, 0xA9, 0xC5, 0xFB, 0xCF,
+    0x8C, 0xD0, 0x95, 0xF0, 0xBE, 0x90, 0xC3, 0xB0, 0xC5, 0xD1, 0xCF, 0xF2, 0xD0, 0x97, 0xF1, 0xB8,
+    0x93, 0xC9, 0xB5, 0xDB, 0xDE, 0xED, 0xE3, 0xB6, 0xA4, 0xDB, 0xEC, 0xED, 0xB5, 0xB6, 0xDE, 0xDA,
+    0xE2, 0xEF, 0xA7, 0xB0, 0xE8, 0xD0, 0xB8, 0xF1, 0xC9, 0x93, 0xDA, 0xB4, 0xEE, 0xDD, 0xB2, 0xE6,
+    0xD7, 0xAA, 0xF8, 0xFF, 0x88, 0x80, 0x99, 0x80, 0xAB, 0x80, 0xFD, 0x80, 0x87, 0x81, 0x89, 0x83,
+    0x9B, 0x85, 0xAD, 0x8F, 0xF7, 0x91, 0x99, 0xB2, 0xAB, 0xD6, 0xFD, 0xFA, 0x86, 0x8F, 0x8B, 0x91,
+    0x9D, 0xB3, 0xA7, 0xD5, 0xE9, 0xFF, 0xBA, 0x80, 0xCF, 0x80, 0xD1, 0x81, 0xF3, 0x82, 0x95, 0x87,
+    0xBF, 0x89, 0xC1, 0x9B, 0xC3, 0xAC, 0xC5, 0xF5, 0xCF, 0x9E, 0xD0, 0xA3, 0xF0, 0xE4, 0x90, 0xAD,
+    0xB1, 0xF7, 0xD3, 0x99, 0xF4, 0xAA, 0x9C, 0xFF, 0xA4, 0x81, 0xED, 0x83, 0xB7, 0x84, 0xD9, 0x8C,
+    0xEB, 0x95, 0xBD, 0xBE, 0xC7, 0xC2, 0xC9, 0xC7, 0xDA, 0xC8, 0xEF, 0xD9, 0xB0, 0xEA, 0xD1, 0xBE,
+    0xF2, 0xC3, 0x96, 0xC4, 0xBB, 0xCC, 0xCC, 0xD4, 0xD5, 0xFD, 0xFE, 0x86, 0x83, 0x8B, 0x85, 0x9D,
+    0x8F, 0xA7, 0x91, 0xE9, 0xB3, 0xBB, 0xD4, 0xCD, 0xFC, 0xD6, 0x85, 0xFB, 0x8E, 0x8D, 0x93, 0x97,
+    0xB5, 0xB9, 0xDF, 0xCB, 0xE1, 0xDC, 0xA2, 0xE5, 0xE7, 0xAF, 0xA8, 0xF0, 0xF8, 0x90, 0x89, 0xB1,
+    0x9B, 0xD3, 0xAD, 0xF5, 0xF6, 0x9F, 0x9B, 0xA0, 0xAD, 0xE0, 0xF7, 0xA0, 0x98, 0xE1, 0xA8, 0xA3,
+    0xF9, 0xE5, 0x8B, 0xAE, 0x9C, 0xF2, 0xA4, 0x96, 0xED, 0xBA, 0xB7, 0xCF, 0xD9, 0xD1, 0xEA, 0xF2,
+    0xBF, 0x97, 0xC0, 0xB9, 0xC0, 0xCA, 0xC0, 0xDF, 0xC1, 0xE0, 0xC2, 0xA1, 0xC7, 0xE2, 0xC9, 0xA7,
+    0xDA, 0xE8, 0xEE, 0xB9, 0xB3, 0xCA, 0xD5, 0xDE, 0xFE, 0xE3, 0x83, 0xA4, 0x84, 0xEC, 0x8C, 0xB4,
+    0x95, 0xDC, 0xBF, 0xE4, 0xC0, 0xAC, 0xC1, 0xF5, 0xC3, 0x9E, 0xC4, 0xA3, 0xCC, 0xE4, 0xD4, 0xAD,
+    0xFD, 0xF6, 0x87, 0x9B, 0x88, 0xAD, 0x98, 0xF7, 0xA8, 0x99, 0xF9, 0xAB, 0x8B, 0xFC, 0x9D, 0x84,
+    0xA6, 0x8C, 0xEA, 0x94, 0xBE, 0xBD, 0xC2, 0xC7, 0xC6, 0xC8, 0xCB, 0xD9, 0xDC, 0xEA, 0xE5, 0xBF,
+    0xAE, 0xC0, 0xF2, 0xC0, 0x97, 0xC1, 0xB8, 0xC3, 0xC9, 0xC5, 0xDA, 0xCE, 0xEF, 0xD3, 0xB0, 0xF4,
+    0xD1, 0x9C, 0xF2, 0xA5, 0x96, 0xEE, 0xBA, 0xB2, 0xCF, 0xD6, 0xD1, 0xFB, 0xF2, 0x8C, 0x97, 0x95,
+    0xB9, 0xBF, 0xCB, 0xC1, 0xDD, 0xC2, 0xE6, 0xC7, 0xAB, 0xC8, 0xFC, 0xD8, 0x85, 0xE9, 0x8E, 0xBB,
+    0x93, 0xCD, 0xB5, 0xD7, 0xDE, 0xF9, 0xE3, 0x8A, 0xA4, 0x9F, 0xEC, 0xA1, 0xB4, 0xE2, 0xDC, 0xA6,
+    0xE5, 0xEB, 0xAF, 0xBC, 0xF0, 0xC4, 0x90, 0xCD, 0xB1, 0xD7, 0xD2, 0xF9, 0xF7, 0x8A, 0x98, 0x9F,
+    0xA8, 0xA1, 0xF8, 0xE3, 0x88, 0xA4, 0x99, 0xEC, 0xAB, 0xB4, 0xFC, 0xDC, 0x84, 0xE5, 0x8D, 0xAF,
+    0x96, 0xF1, 0xBA, 0x93, 0xCF, 0xB5, 0xD1, 0xDE, 0xF3, 0xE3, 0x94, 0xA4, 0xBD, 0xEC, 0xC7, 0xB4,
+    0xC8, 0xDD, 0xD8, 0xE6, 0xE9, 0xAB, 0xBA, 0xFC, 0xCE, 0x84, 0xD3, 0x8D, 0xF5, 0x96, 0x9F, 0xBB,
+    0xA1, 0xCD, 0xE3, 0xD7, 0xA4, 0xF8, 0xED, 0x88, 0xB6, 0x99, 0xDA, 0xAB, 0xEE, 0xFC, 0xB2, 0x85,
+    0xD7, 0x8F, 0xF9, 0x90, 0x8B, 0xB1, 0x9D, 0xD3, 0xA7, 0xF5, 0xE8, 0x9F, 0xB9, 0xA0, 0xCB, 0xE0,
+    0xDD, 0xA1, 0xE6, 0xE2, 0xAA, 0xA7, 0xFF, 0xE9, 0x81, 0xBA, 0x82, 0xCE, 0x86, 0xD2, 0x8B, 0xF6,
+    0x9C, 0x9A, 0xA5, 0xAE, 0xEF, 0xF2, 0xB1, 0x97, 0xD2, 0xB9, 0xF6, 0xCA, 0x9A, 0xDF, 0xAF, 0xE1,
+    0xF0, 0xA3, 0x91, 0xE4, 0xB3, 0xAC, 0xD4, 0xF4, 0xFC, 0x9D, 0x85, 0xA6, 0x8F, 0xEA, 0x91, 0xBE,
+    0xB2, 0xC2, 0xD6, 0xC6, 0xFB, 0xCB, 0x8C, 0xDC, 0x95, 0xE4, 0xBE, 0xAC, 0xC3, 0xF4, 0xC5, 0x9D,
+    0xCE, 0xA6, 0xD2, 0xEB, 0xF6, 0xBC, 0x9B, 0xC5, 0xAD, 0xCF, 0xF6, 0xD1, 0x9B, 0xF2, 0xAC, 0x96,
+    0xF5, 0xBA, 0x9F, 0xCF, 0xA1, 0xD1, 0xE2, 0xF3, 0xA7, 0x94, 0xE8, 0xBC, 0xB8, 0xC5, 0xC8, 0xCF,
+    0xD9, 0xD0, 0xEA, 0xF1, 0xBF, 0x92, 0xC0, 0xB6, 0xC0, 0xDB, 0xC0, 0xEC, 0xC1, 0xB5, 0xC2, 0xDE,
+    0xC6, 0xE3, 0xCB, 0xA4, 0xDC, 0xED, 0xE4, 0xB6, 0xAD, 0xDB, 0xF7, 0xED, 0x98, 0xB6, 0xA9, 0xDA,
+    0xFB, 0xEE, 0x8C, 0xB3, 0x95, 0xD5, 0xBF, 0xFF, 0xC0, 0x81, 0xC1, 0x82, 0xC3, 0x87, 0xC5, 0x88,
+    0xCF, 0x99, 0xD1, 0xAA, 0xF3, 0xFF, 0x95, 0x80, 0xBE, 0x80, 0xC2, 0x80, 0xC6, 0x81, 0xCA, 0x82,
+    0xDE, 0x87, 0xE2, 0x88, 0xA6, 0x99, 0xEA, 0xAB, 0xBE, 0xFC, 0xC2, 0x84, 0xC7, 0x8D, 0xC9, 0x96,
+    0xDB, 0xBB, 0xED, 0xCC, 0xB7, 0xD5, 0xD8, 0xFF, 0xE9, 0x80, 0xBA, 0x81, 0xCE, 0x83, 0xD2, 0x84,
+    0xF6, 0x8D, 0x9A, 0x96, 0xAE, 0xBA, 0xF2, 0xCE, 0x96, 0xD3, 0xBB, 0xF5, 0xCC, 0x9F, 0xD5, 0xA0,
+    0xFF, 0xE1, 0x81, 0xA2, 0x82, 0xE6, 0x86, 0xAA, 0x8B, 0xFE, 0x9D, 0x82, 0xA6, 0x86, 0xEA, 0x8A,
+    0xBE, 0x9F, 0xC2, 0xA1, 0xC6, 0xE2, 0xCA, 0xA7, 0xDF, 0xE8, 0xE1, 0xB9, 0xA2, 0xCA, 0xE6, 0xDE,
+    0xAB, 0xE3, 0xFC, 0xA5, 0x85, 0xEE, 0x8F, 0xB2, 0x90, 0xD6, 0xB0, 0xFA, 0xD1, 0x8E, 0xF2, 0x93,
+    0x96, 0xB4, 0xBA, 0xDC, 0xCE, 0xE4, 0xD3, 0xAD, 0xF4, 0xF6, 0x9C, 0x9B, 0xA5, 0xAD, 0xEF, 0xF7,
+    0xB1, 0x98, 0xD2, 0xA8, 0xF6, 0xF9, 0x9A, 0x8A, 0xAF, 0x9E, 0xF1, 0xA2, 0x93, 0xE7, 0xB5, 0xA9,
+    0xDE, 0xFB, 0xE2, 0x8C, 0xA7, 0x95, 0xE9, 0xBF, 0xBB, 0xC0, 0xCD, 0xC0, 0xD6, 0xC1, 0xFB, 0xC2,
+    0x8C, 0xC7, 0x95, 0xC9, 0xBE, 0xDB, 0xC3, 0xED, 0xC4, 0xB6, 0xCD, 0xDB, 0xD7, 0xEC, 0xF8, 0xB5,
+    0x89, 0xDE, 0x9B, 0xE2, 0xAC, 0xA6, 0xF5, 0xEA, 0x9F, 0xBF, 0xA0, 0xC1, 0xE0, 0xC3, 0xA1, 0xC4,
+    0xE2, 0xCC, 0xA7, 0xD5, 0xE8, 0xFF, 0xB9, 0x80, 0xCA, 0x80, 0xDE, 0x81, 0xE2, 0x82, 0xA6, 0x87,
+    0xEA, 0x89, 0xBE, 0x9A, 0xC2, 0xAE, 0xC6, 0xF3, 0xCA, 0x94, 0xDF, 0xBD, 0xE1, 0xC6, 0xA3, 0xCB,
+    0xE4, 0xDD, 0xAD, 0xE6, 0xF6, 0xAA, 0x9B, 0xFF, 0xAD, 0x81, 0xF6, 0x83, 0x9A, 0x84, 0xAE, 0x8C,
+    0xF2, 0x94, 0x96, 0xBD, 0xBA, 0xC7, 0xCE, 0xC9, 0xD3, 0xDA, 0xF4, 0xEF, 0x9D, 0xB0, 0xA6, 0xD0,
+    0xEA, 0xF0, 0xBF, 0x91, 0xC0, 0xB3, 0xC0, 0xD4, 0xC0, 0xFD, 0xC1, 0x86, 0xC2, 0x8B, 0xC6, 0x9C,
+    0xCA, 0xA5, 0xDE, 0xEE, 0xE2, 0xB3, 0xA7, 0xD4, 0xE9, 0xFC, 0xBA, 0x85, 0xCF, 0x8F, 0xD1, 0x90,
+    0xF3, 0xB1, 0x95, 0xD2, 0xBF, 0xF6, 0xC0, 0x9A, 0xC1, 0xAF, 0xC3, 0xF0, 0xC5, 0x91, 0xCE, 0xB2,
+    0xD2, 0xD7, 0xF6, 0xF8, 0x9B, 0x89, 0xAC, 0x9B, 0xF4, 0xAD, 0x9C, 0xF6, 0xA4, 0x9A, 0xED, 0xAE,
+    0xB7, 0xF3, 0xD9, 0x95, 0xEA, 0xBE, 0xBE, 0xC3, 0xC2, 0xC5, 0xC7, 0xCE, 0xC8, 0xD3, 0xD9, 0xF4,
+    0xEA, 0x9D, 0xBF, 0xA6, 0xC1, 0xEA, 0xC3, 0xBF, 0xC4, 0xC0, 0xCC, 0xC1, 0xD5, 0xC2, 0xFE, 0xC7,
+    0x83, 0xC8, 0x84, 0xD8, 0x8D, 0xE8, 0x96, 0xB8, 0xBB, 0xC8, 0xCD, 0xD8, 0xD6, 0xE9, 0xFB, 0xBA,
+    0x8C, 0xCF, 0x94, 0xD1, 0xBD, 0xF3, 0xC6, 0x95, 0xCB, 0xBE, 0xDD, 0xC3, 0xE7, 0xC4, 0xA8, 0xCD,
+    0xF9, 0xD7, 0x8A, 0xF8, 0x9F, 0x88, 0xA0, 0x98, 0xE0, 0xA8, 0xA0, 0xF9, 0xE0, 0x8B, 0xA1, 0x9C,
+    0xE3, 0xA4, 0xA5, 0xED, 0xEF, 0xB7, 0xB0, 0xD8, 0xD0, 0xE8, 0xF1, 0xB9, 0x92, 0xCA, 0xB6, 0xDE,
+    0xDB, 0xE2, 0xEC, 0xA7, 0xB5, 0xE8, 0xDF, 0xB8, 0xE0, 0xC9, 0xA0, 0xDA, 0xE1, 0xEE, 0xA2, 0xB3,
+    0xE7, 0xD5, 0xA9, 0xFE, 0xFA, 0x82, 0x8F, 0x87, 0x91, 0x89, 0xB3, 0x9B, 0xD5, 0xAD, 0xFF, 0xF6,
+    0x81, 0x9B, 0x82, 0xAD, 0x86, 0xF7, 0x8A, 0x99, 0x9F, 0xAB, 0xA1, 0xFD, 0xE3, 0x87, 0xA4, 0x88,
+    0xEC, 0x98, 0xB4, 0xA9, 0xDC, 0xFB, 0xE4, 0x8C, 0xAD, 0x95, 0xF7, 0xBF, 0x99, 0xC0, 0xAB, 0xC0,
+    0xFC, 0xC0, 0x85, 0xC1, 0x8E, 0xC3, 0x93, 0xC5, 0xB4, 0xCF, 0xDD, 0xD1, 0xE6, 0xF2, 0xAB, 0x97,
+    0xFC, 0xB9, 0x84, 0xCA, 0x8C, 0xDE, 0x95, 0xE2, 0xBE, 0xA6, 0xC3, 0xEA, 0xC5, 0xBF, 0xCE, 0xC0,
+    0xD2, 0xC1, 0xF7, 0xC2, 0x98, 0xC7, 0xA9, 0xC9, 0xFA, 0xDB, 0x8F, 0xEC, 0x90, 0xB4, 0xB1, 0xDC,
+    0xD3, 0xE4, 0xF4, 0xAD, 0x9D, 0xF6, 0xA7, 0x9A, 0xE8, 0xAE, 0xB8, 0xF3, 0xC8, 0x95, 0xD9, 0xBE,
+    0xEB, 0xC3, 0xBD, 0xC4, 0xC6, 0xCC, 0xCB, 0xD5, 0xDC, 0xFE, 0xE5, 0x83, 0xAE, 0x84, 0xF2, 0x8C,
+    0x96, 0x95, 0xBA, 0xBF, 0xCE, 0xC1, 0xD2, 0xC2, 0xF7, 0xC7, 0x98, 0xC8, 0xA9, 0xD8, 0xFA, 0xE8,
+    0x8F, 0xB9, 0x90, 0xCB, 0xB0, 0xDD, 0xD1, 0xE7, 0xF2, 0xA8, 0x97, 0xF9, 0xB9, 0x8B, 0xCA, 0x9D,
+    0xDE, 0xA6, 0xE2, 0xEB, 0xA6, 0xBC, 0xEB, 0xC4, 0xBD, 0xCD, 0xC6, 0xD7, 0xCB, 0xF8, 0xDC, 0x89,
+    0xE5, 0x9A, 0xAF, 0xAF, 0xF1, 0xF1, 0x93, 0x92, 0xB4, 0xB6, 0xDC, 0xDA, 0xE4, 0xEF, 0xAD, 0xB0,
+    0xF6, 0xD0, 0x9A, 0xF1, 0xAF, 0x93, 0xF0, 0xB5, 0x90, 0xDE, 0xB0, 0xE2, 0xD1, 0xA6, 0xF2, 0xEB,
+    0x96, 0xBC, 0xBB, 0xC4, 0xCD, 0xCC, 0xD6, 0xD5, 0xFB, 0xFE, 0x8C, 0x83, 0x95, 0x85, 0xBF, 0x8F,
+    0xC1, 0x91, 0xC3, 0xB2, 0xC5, 0xD7, 0xCF, 0xF8, 0xD0, 0x89, 0xF1, 0x9A, 0x93, 0xAF, 0xB5, 0xF1,
+    0xDF, 0x93, 0xE0, 0xB4, 0xA0, 0xDD, 0xE0, 0xE7, 0xA1, 0xA8, 0xE2, 0xF8, 0xA6, 0x89, 0xEB, 0x9B,
+    0xBD, 0xAC, 0xC7, 0xF4, 0xC9, 0x9D, 0xDA, 0xA6, 0xEE, 0xEB, 0xB2, 0xBC, 0xD7, 0xC4, 0xF9, 0xCD,
+    0x8A, 0xD6, 0x9F, 0xFA, 0xA0, 0x8E, 0xE1, 0x92, 0xA3, 0xB7, 0xE5, 0xD9, 0xAF, 0xEA, 0xF0, 0xBE,
+    0x91, 0xC3, 0xB3, 0xC5, 0xD4, 0xCF, 0xFD, 0xD0, 0x86, 0xF1, 0x8B, 0x93, 0x9C, 0xB5, 0xA4, 0xDF,
+    0xEC, 0xE1, 0xB5, 0xA2, 0xDE, 0xE6, 0xE2, 0xAB, 0xA7, 0xFC, 0xE9, 0x84, 0xBA, 0x8D, 0xCE, 0x97,
+    0xD2, 0xB8, 0xF6, 0xC9, 0x9A, 0xDA, 0xAF, 0xEE, 0xF0, 0xB2, 0x91, 0xD7, 0xB3, 0xF9, 0xD4, 0x8B,
+    0xFD, 0x9C, 0x87, 0xA5, 0x89, 0xEF, 0x9B, 0xB1, 0xAC, 0xD3, 0xF4, 0xF5, 0x9D, 0x9E, 0xA6, 0xA2,
+    0xEA, 0xE6, 0xBE, 0xAB, 0xC3, 0xFD, 0xC5, 0x86, 0xCE, 0x8B, 0xD2, 0x9C, 0xF6, 0xA5, 0x9A, 0xEE,
+    0xAE, 0xB2, 0xF3, 0xD6, 0x95, 0xFB, 0xBE, 0x8D, 0xC3, 0x97, 0xC5, 0xB8, 0xCF, 0xC9, 0xD1, 0xDA,
+    0xF2, 0xEF, 0x97, 0xB0, 0xB8, 0xD0, 0xC8, 0xF0, 0xD9, 0x91, 0xEA, 0xB2, 0xBE, 0xD7, 0xC2, 0xF9,
+    0xC7, 0x8A, 0xC8, 0x9F, 0xD8, 0xA0, 0xE8, 0xE1, 0xB8, 0xA2, 0xC9, 0xE6, 0xDB, 0xAB, 0xEC, 0xFC,
+    0xB4, 0x85, 0xDD, 0x8F, 0xE7, 0x90, 0xA9, 0xB1, 0xFB, 0xD3, 0x8D, 0xF4, 0x96, 0x9C, 0xBB, 0xA4,
+    0xCD, 0xEC, 0xD7, 0xB5, 0xF8, 0xDE, 0x88, 0xE3, 0x99, 0xA5, 0xAA, 0xEF, 0xFE, 0xB1, 0x83, 0xD2,
+    0x85, 0xF6, 0x8E, 0x9A, 0x93, 0xAE, 0xB5, 0xF2, 0xDF, 0x96, 0xE0, 0xBB, 0xA0, 0xCC, 0xE0, 0xD4,
+    0xA1, 0xFD, 0xE2, 0x87, 0xA7, 0x88, 0xE9, 0x98, 0xBB, 0xA9, 0xCD, 0xFB, 0xD7, 0x8C, 0xF8, 0x95,
+    0x88, 0xBE, 0x98, 0xC2, 0xA8, 0xC6, 0xF9, 0xCA, 0x8A, 0xDF, 0x9F, 0xE1, 0xA0, 0xA3, 0xE1, 0xE5,
+    0xA3, 0xAE, 0xE4, 0xF2, 0xAC, 0x97, 0xF5, 0xB9, 0x9F, 0xCA, 0xA1, 0xDE, 0xE2, 0xE2, 0xA7, 0xA7,
+    0xE8, 0xE9, 0xB8, 0xBA, 0xC9, 0xCE, 0xDB, 0xD3, 0xEC, 0xF4, 0xB5, 0x9D, 0xDE, 0xA7, 0xE2, 0xE8,
+    0xA6, 0xB9, 0xEB, 0xCB, 0xBD, 0xDC, 0xC6, 0xE4, 0xCB, 0xAD, 0xDC, 0xF6, 0xE4, 0x9B, 0xAD, 0xAC,
+    0xF7, 0xF4, 0x99, 0x9D, 0xAA, 0xA7, 0xFE, 0xE9, 0x82, 0xBA, 0x87, 0xCE, 0x89, 0xD2, 0x9A, 0xF6,
+    0xAF, 0x9A, 0xF0, 0xAE, 0x90, 0xF3, 0xB0, 0x95, 0xD1, 0xBF, 0xF3, 0xC0, 0x95, 0xC1, 0xBE, 0xC3,
+    0xC3, 0xC5, 0xC4, 0xCE, 0xCD, 0xD3, 0xD6, 0xF4, 0xFB, 0x9D, 0x8C, 0xA6, 0x94, 0xEA, 0xBC, 0xBE,
+    0xC5, 0xC2, 0xCF, 0xC7, 0xD0, 0xC8, 0xF1, 0xD9, 0x92, 0xEA, 0xB7, 0xBE, 0xD8, 0xC2, 0xE8, 0xC7,
+    0xB9, 0xC8, 0xCA, 0xD8, 0xDF, 0xE9, 0xE0, 0xBA, 0xA1, 0xCF, 0xE3, 0xD1, 0xA4, 0xF2, 0xED, 0x96,
+    0xB6, 0xBB, 0xDA, 0xCD, 0xEE, 0xD6, 0xB3, 0xFB, 0xD4, 0x8D, 0xFD, 0x96, 0x87, 0xBB, 0x89, 0xCD,
+    0x9B, 0xD7, 0xAC, 0xF9, 0xF5, 0x8B, 0x9E, 0x9C, 0xA2, 0xA4, 0xE6, 0xEC, 0xAA, 0xB5, 0xFF, 0xDF,
+    0x81, 0xE0, 0x82, 0xA0, 0x87, 0xE0, 0x89, 0xA0, 0x9A, 0xE0, 0xAE, 0xA0, 0xF3, 0xE0, 0x95, 0xA1,
+    0xBE, 0xE3, 0xC2, 0xA5, 0xC7, 0xEE, 0xC9, 0xB3, 0xDA, 0xD4, 0xEE, 0xFD, 0xB3, 0x86, 0xD4, 0x8A,
+    0xFC, 0x9F, 0x84, 0xA0, 0x8C, 0xE0, 0x94, 0xA0, 0xBD, 0xE0, 0xC7, 0xA0, 0xC8, 0xE1, 0xD8, 0xA2,
+    0xE9, 0xE7, 0xBB, 0xA8, 0xCC, 0xF8, 0xD4, 0x89, 0xFD, 0x9A, 0x87, 0xAF, 0x89, 0xF1, 0x9B, 0x93,
+    0xAC, 0xB5, 0xF4, 0xDF, 0x9C, 0xE0, 0xA5, 0xA0, 0xEE, 0xE0, 0xB2, 0xA1, 0xD7, 0xE3, 0xF9, 0xA4,
+    0x8A, 0xED, 0x9E, 0xB7, 0xA3, 0xD9, 0xE5, 0xEB, 0xAE, 0xBC, 0xF3, 0xC4, 0x95, 0xCD, 0xBE, 0xD7,
+    0xC3, 0xF9, 0xC4, 0x8A, 0xCD, 0x9F, 0xD7, 0xA0, 0xF9, 0xE1, 0x8B, 0xA2, 0x9C, 0xE6, 0xA4, 0xAA,
+    0xED, 0xFE, 0xB7, 0x83, 0xD8, 0x85, 0xE8, 0x8E, 0xB8, 0x93, 0xC8, 0xB5, 0xD8, 0xDE, 0xE8, 0xE3,
+    0xB9, 0xA4, 0xCA, 0xEC, 0xDE, 0xB5, 0xE3, 0xDE, 0xA5, 0xE3, 0xEE, 0xA5, 0xB3, 0xEE, 0xD5, 0xB2,
+    0xFE, 0xD7, 0x82, 0xF8, 0x87, 0x88, 0x88, 0x98, 0x98, 0xA8, 0xA8, 0xF8, 0xF8, 0x88, 0x89, 0x99,
+    0x9B, 0xAB, 0xAD, 0xFD, 0xF7, 0x87, 0x98, 0x88, 0xA8, 0x98, 0xF8, 0xA8, 0x88, 0xF9, 0x98, 0x8B,
+    0xA9, 0x9D, 0xFB, 0xA7, 0x8D, 0xE8, 0x97, 0xB8, 0xB8, 0xC8, 0xC8, 0xD8, 0xD9, 0xE9, 0xEA, 0xBA,
+    0xBF, 0xCF, 0xC1, 0xD1, 0xC2, 0xF2, 0xC7, 0x97, 0xC8, 0xB8, 0xD8, 0xC9, 0xE8, 0xDA, 0xB9, 0xEF,
+    0xCA, 0xB1, 0xDF, 0xD2, 0xE1, 0xF7, 0xA2, 0x98, 0xE7, 0xA8, 0xA9, 0xF9, 0xFB, 0x8B, 0x8C, 0x9C,
+    0x94, 0xA4, 0xBC, 0xEC, 0xC4, 0xB4, 0xCD, 0xDD, 0xD7, 0xE6, 0xF8, 0xAB, 0x89, 0xFC, 0x9B, 0x84,
+    0xAC, 0x8C, 0xF4, 0x94, 0x9C, 0xBD, 0xA4, 0xC7, 0xEC, 0xC9, 0xB5, 0xDA, 0xDE, 0xEE, 0xE3, 0xB3,
+    0xA4, 0xD4, 0xEC, 0xFC, 0xB5, 0x85, 0xDE, 0x8F, 0xE2, 0x90, 0xA6, 0xB1, 0xEA, 0xD3, 0xBE, 0xF4,
+    0xC3, 0x9C, 0xC4, 0xA5, 0xCC, 0xEE, 0xD4, 0xB3, 0xFD, 0xD4, 0x87, 0xFD, 0x88, 0x87, 0x99, 0x89,
+    0xAB, 0x9B, 0xFD, 0xAD, 0x87, 0xF6, 0x89, 0x9A, 0x9A, 0xAE, 0xAE, 0xF2, 0xF2, 0x96, 0x97, 0xBB,
+    0xB9, 0xCD, 0xCB, 0xD7, 0xDC, 0xF8, 0xE5, 0x89, 0xAE, 0x9A, 0xF2, 0xAE, 0x96, 0xF3, 0xBA, 0x95,
+    0xCF, 0xBF, 0xD1, 0xC0, 0xF3, 0xC1, 0x94, 0xC2, 0xBD, 0xC6, 0xC6, 0xCA, 0xCB, 0xDF, 0xDC, 0xE0,
+    0xE5, 0xA1, 0xAE, 0xE2, 0xF2, 0xA6, 0x97, 0xEB, 0xB9, 0xBD, 0xCA, 0xC7, 0xDE, 0xC8, 0xE3, 0xD9,
+    0xA4, 0xEA, 0xED, 0xBE, 0xB6, 0xC3, 0xDA, 0xC5, 0xEF, 0xCE, 0xB0, 0xD3, 0xD1, 0xF5, 0xF2, 0x9E,
+    0x97, 0xA3, 0xB9, 0xE5, 0xCB, 0xAF, 0xDC, 0xF0, 0xE4, 0x91, 0xAD, 0xB2, 0xF7, 0xD6, 0x99, 0xFB,
+    0xAA, 0x8D, 0xFF, 0x97, 0x81, 0xB8, 0x83, 0xC8, 0x85, 0xD8, 0x8E, 0xE8, 0x93, 0xB8, 0xB4, 0xC8,
+    0xDC, 0xD8, 0xE5, 0xE9, 0xAE, 0xBA, 0xF3, 0xCE, 0x95, 0xD3, 0xBE, 0xF5, 0xC3, 0x9F, 0xC4, 0xA0,
+    0xCC, 0xE1, 0xD4, 0xA2, 0xFD, 0xE7, 0x87, 0xA8, 0x88, 0xF8, 0x98, 0x88, 0xA9, 0x98, 0xFB, 0xA8,
+    0x8D, 0xF9, 0x97, 0x8B, 0xB8, 0x9D, 0xC8, 0xA7, 0xD8, 0xE8, 0xE8, 0xB9, 0xB9, 0xCA, 0xCB, 0xDE,
+    0xDC, 0xE3, 0xE5, 0xA4, 0xAE, 0xED, 0xF2, 0xB7, 0x97, 0xD8, 0xB9, 0xE8, 0xCA, 0xB8, 0xDF, 0xC9,
+    0xE1, 0xDA, 0xA2, 0xEF, 0xE7, 0xB1, 0xA8, 0xD2, 0xF8, 0xF6, 0x89, 0x9B, 0x9A, 0xAD, 0xAE, 0xF7,
+    0xF2, 0x99, 0x97, 0xAA, 0xB9, 0xFE, 0xCB, 0x82, 0xDC, 0x87, 0xE4, 0x88, 0xAC, 0x99, 0xF4, 0xAB,
+    0x9C, 0xFC, 0xA4, 0x84, 0xED, 0x8C, 0xB7, 0x95, 0xD9, 0xBF, 0xEB, 0xC0, 0xBD, 0xC1, 0xC6, 0xC3,
+    0xCB, 0xC4, 0xDC, 0xCD, 0xE5, 0xD6, 0xAE, 0xFB, 0xF3, 0x8D, 0x94, 0x96, 0xBC, 0xBA, 0xC4, 0xCE,
+    0xCC, 0xD3, 0xD5, 0xF4, 0xFE, 0x9D, 0x83, 0xA6, 0x85, 0xEA, 0x8F, 0xBE, 0x90, 0xC2, 0xB0, 0xC6,
+    0xD1, 0xCA, 0xF2, 0xDF, 0x97, 0xE0, 0xB8, 0xA0, 0xC9, 0xE0, 0xDB, 0xA1, 0xEC, 0xE2, 0xB4, 0xA7,
+    0xDD, 0xE9, 0xE7, 0xBA, 0xA8, 0xCF, 0xF8, 0xD1, 0x89, 0xF2, 0x9A, 0x96, 0xAF, 0xBA, 0xF1, 0xCE,
+    0x93, 0xD3, 0xB4, 0xF5, 0xDD, 0x9F, 0xE6, 0xA0, 0xAA, 0xE1, 0xFE, 0xA3, 0x83, 0xE4, 0x85, 0xAC,
+    0x8E, 0xF4, 0x92, 0x9C, 0xB7, 0xA4, 0xD9, 0xEC, 0xEB, 0xB5, 0xBC, 0xDE, 0xC4, 0xE2, 0xCD, 0xA7,
+    0xD6, 0xE8, 0xFA, 0xB9, 0x8F, 0xCA, 0x91, 0xDE, 0xB2, 0xE2, 0xD7, 0xA6, 0xF8, 0xEB, 0x88, 0xBC,
+    0x99, 0xC4, 0xAB, 0xCC, 0xFC, 0xD4, 0x85, 0xFD, 0x8E, 0x87, 0x93, 0x89, 0xB5, 0x9B, 0xDF, 0xAD,
+    0xE1, 0xF6, 0xA3, 0x9B, 0xE4, 0xAD, 0xAC, 0xF6, 0xF4, 0x9A, 0x9D, 0xAF, 0xA7, 0xF1, 0xE9, 0x93,
+    0xBA, 0xB4, 0xCE, 0xDC, 0xD2, 0xE5, 0xF7, 0xAE, 0x98, 0xF3, 0xA8, 0x95, 0xF9, 0xBF, 0x8B, 0xC0,
+    0x9D, 0xC0, 0xA6, 0xC0, 0xEB, 0xC0, 0xBC, 0xC1, 0xC5, 0xC3, 0xCE, 0xC4, 0xD3, 0xCD, 0xF4, 0xD6,
+    0x9D, 0xFB, 0xA6, 0x8D, 0xEB, 0x97, 0xBD, 0xB8, 0xC7, 0xC8, 0xC9, 0xD9, 0xDA, 0xEA, 0xEF, 0xBF,
+    0xB0, 0xC0, 0xD0, 0xC0, 0xF1, 0xC1, 0x92, 0xC2, 0xB7, 0xC6, 0xD8, 0xCA, 0xE9, 0xDF, 0xBA, 0xE0,
+    0xCF, 0xA0, 0xD0, 0xE1, 0xF0, 0xA2, 0x91, 0xE7, 0xB3, 0xA9, 0xD4, 0xFB, 0xFC, 0x8C, 0x85, 0x95,
+    0x8F, 0xBF, 0x91, 0xC1, 0xB3, 0xC3, 0xD4, 0xC5, 0xFD, 0xCE, 0x86, 0xD3, 0x8B, 0xF5, 0x9C, 0x9F,
+    0xA5, 0xA1, 0xEF, 0xE3, 0xB1, 0xA4, 0xD2, 0xEC, 0xF6, 0xB5, 0x9B, 0xDE, 0xAD, 0xE2, 0xF6, 0xA6,
+    0x9B, 0xEB, 0xAD, 0xBD, 0xF6, 0xC7, 0x9A, 0xC8, 0xAF, 0xD8, 0xF0, 0xE8, 0x91, 0xB9, 0xB2, 0xCB,
+    0xD6, 0xDD, 0xFB, 0xE6, 0x8C, 0xAB, 0x95, 0xFD, 0xBF, 0x87, 0xC0, 0x89, 0xC0, 0x9A, 0xC0, 0xAF,
+    0xC0, 0xF0, 0xC0, 0x91, 0xC1, 0xB2, 0xC3, 0xD7, 0xC5, 0xF8, 0xCE, 0x89, 0xD3, 0x9A, 0xF5, 0xAF,
+    0x9F, 0xF0, 0xA1, 0x90, 0xE2, 0xB0, 0xA6, 0xD1, 0xEA, 0xF3, 0xBF, 0x94, 0xC0, 0xBC, 0xC0, 0xC5,
+    0xC0, 0xCE, 0xC1, 0xD3, 0xC2, 0xF4, 0xC7, 0x9D, 0xC8, 0xA6, 0xD8, 0xEB, 0xE8, 0xBC, 0xB9, 0xC5,
+    0xCB, 0xCF, 0xDC, 0xD0, 0xE5, 0xF1, 0xAE, 0x92, 0xF3, 0xB6, 0x95, 0xDB, 0xBF, 0xED, 0xC0, 0xB7,
+    0xC1, 0xD8, 0xC3, 0xE9, 0xC4, 0xBA, 0xCD, 0xCF, 0xD7, 0xD0, 0xF8, 0xF1, 0x89, 0x92, 0x9A, 0xB6,
+    0xAE, 0xDA, 0xF2, 0xEE, 0x97, 0xB3, 0xB8, 0xD5, 0xC8, 0xFF, 0xD9, 0x80, 0xEA, 0x81, 0xBE, 0x82,
+    0xC2, 0x86, 0xC6, 0x8B, 0xCA, 0x9C, 0xDE, 0xA5, 0xE2, 0xEE, 0xA6, 0xB3, 0xEB, 0xD5, 0xBD, 0xFE,
+    0xC6, 0x82, 0xCB, 0x87, 0xDD, 0x88, 0xE7, 0x99, 0xA9, 0xAA, 0xFB, 0xFE, 0x8D, 0x83, 0x96, 0x85,
+    0xBA, 0x8F, 0xCE, 0x91, 0xD2, 0xB2, 0xF6, 0xD7, 0x9A, 0xF8, 0xAF, 0x88, 0xF0, 0x98, 0x90, 0xA9,
+    0xB0, 0xFB, 0xD0, 0x8D, 0xF1, 0x96, 0x93, 0xBB, 0xB5, 0xCD, 0xDF, 0xD7, 0xE0, 0xF8, 0xA1, 0x89,
+    0xE2, 0x9B, 0xA6, 0xAC, 0xEA, 0xF4, 0xBE, 0x9D, 0xC3, 0xA7, 0xC5, 0xE8, 0xCF, 0xB9, 0xD0, 0xCA,
+    0xF0, 0xDF, 0x91, 0xE0, 0xB2, 0xA0, 0xD7, 0xE0, 0xF9, 0xA1, 0x8A, 0xE2, 0x9E, 0xA6, 0xA3, 0xEA,
+    0xE5, 0xBE, 0xAE, 0xC3, 0xF2, 0xC5, 0x97, 0xCE, 0xB8, 0xD2, 0xC9, 0xF6, 0xDA, 0x9B, 0xEF, 0xAC,
+    0xB1, 0xF5, 0xD3, 0x9F, 0xF4, 0xA0, 0x9C, 0xE1, 0xA4, 0xA3, 0xED, 0xE5, 0xB7, 0xAE, 0xD8, 0xF2,
+    0xE8, 0x97, 0xB9, 0xB8, 0xCB, 0xC8, 0xDD, 0xD9, 0xE6, 0xEA, 0xAB, 0xBF, 0xFC, 0xC1, 0x84, 0xC2,
+    0x8D, 0xC6, 0x96, 0xCA, 0xBB, 0xDE, 0xCC, 0xE2, 0xD5, 0xA7, 0xFE, 0xE8, 0x82, 0xB9, 0x87, 0xCB,
+    0x89, 0xDD, 0x9A, 0xE7, 0xAF, 0xA9, 0xF0, 0xFB, 0x90, 0x8C, 0xB1, 0x94, 0xD3, 0xBC, 0xF5, 0xC5,
+    0x9F, 0xCE, 0xA0, 0xD2, 0xE1, 0xF6, 0xA2, 0x9B, 0xE7, 0xAD, 0xA9, 0xF6, 0xFB, 0x9A, 0x8C, 0xAF,
+    0x94, 0xF1, 0xBC, 0x93, 0xC5, 0xB5, 0xCF, 0xDE, 0xD1, 0xE3, 0xF2, 0xA4, 0x97, 0xED, 0xB9, 0xB7,
+    0xCA, 0xD9, 0xDE, 0xEA, 0xE3, 0xBF, 0xA4, 0xC0, 0xEC, 0xC0, 0xB5, 0xC1, 0xDE, 0xC3, 0xE3, 0xC4,
+    0xA4, 0xCD, 0xED, 0xD7, 0xB6, 0xF8, 0xDB, 0x88, 0xEC, 0x99, 0xB4, 0xAA, 0xDC, 0xFE, 0xE4, 0x83,
+    0xAD, 0x84, 0xF7, 0x8C, 0x99, 0x95, 0xAB, 0xBF, 0xFD, 0xC1, 0x87, 0xC2, 0x88, 0xC6, 0x99, 0xCA,
+    0xAA, 0xDE, 0xFF, 0xE2, 0x80, 0xA7, 0x81, 0xE9, 0x83, 0xBB, 0x84, 0xCD, 0x8C, 0xD7, 0x95, 0xF9,
+    0xBE, 0x8B, 0xC3, 0x9D, 0xC5, 0xA6, 0xCF, 0xEB, 0xD1, 0xBC, 0xF2, 0xC5, 0x96, 0xCE, 0xBB, 0xD2,
+    0xCC, 0xF6, 0xD5, 0x9B, 0xFE, 0xAC, 0x82, 0xF5, 0x86, 0x9F, 0x8B, 0xA1, 0x9D, 0xE3, 0xA7, 0xA5,
+    0xE8, 0xEF, 0xB8, 0xB0, 0xC9, 0xD0, 0xDB, 0xF1, 0xEC, 0x92, 0xB5, 0xB7, 0xDF, 0xD9, 0xE1, 0xEA,
+    0xA2, 0xBF, 0xE7, 0xC1, 0xA9, 0xC2, 0xFA, 0xC6, 0x8F, 0xCB, 0x90, 0xDD, 0xB1, 0xE7, 0xD2, 0xA9,
+    0xF7, 0xFA, 0x99, 0x8F, 0xAA, 0x91, 0xFE, 0xB3, 0x82, 0xD4, 0x86, 0xFC, 0x8B, 0x84, 0x9C, 0x8C,
+    0xA4, 0x94, 0xEC, 0xBC, 0xB4, 0xC5, 0xDC, 0xCF, 0xE5, 0xD0, 0xAE, 0xF1, 0xF3, 0x93, 0x94, 0xB4,
+    0xBC, 0xDC, 0xC4, 0xE4, 0xCD, 0xAD, 0xD6, 0xF6, 0xFA, 0x9B, 0x8F, 0xAC, 0x91, 0xF4, 0xB3, 0x9C,
+    0xD4, 0xA4, 0xFC, 0xED, 0x84, 0xB6, 0x8D, 0xDA, 0x97, 0xEE, 0xB8, 0xB2, 0xC9, 0xD6, 0xDB, 0xFB,
+    0xEC, 0x8C, 0xB5, 0x95, 0xDF, 0xBF, 0xE1, 0xC0, 0xA3, 0xC1, 0xE4, 0xC3, 0xAD, 0xC4, 0xF6, 0xCC,
+    0x9B, 0xD5, 0xAC, 0xFF, 0xF5, 0x81, 0x9E, 0x82, 0xA2, 0x86, 0xE6, 0x8A, 0xAA, 0x9F, 0xFE, 0xA1,
+    0x82, 0xE2, 0x86, 0xA6, 0x8B, 0xEA, 0x9D, 0xBE, 0xA6, 0xC2, 0xEA, 0xC6, 0xBF, 0xCB, 0xC0, 0xDD,
+    0xC1, 0xE6, 0xC2, 0xAB, 0xC7, 0xFC, 0xC9, 0x85, 0xDA, 0x8E, 0xEE, 0x93, 0xB2, 0xB4, 0xD6, 0xDC,
+    0xFA, 0xE5, 0x8F, 0xAE, 0x90, 0xF2, 0xB0, 0x96, 0xD1, 0xBA, 0xF3, 0xCF, 0x95, 0xD0, 0xBE, 0xF0,
+    0xC3, 0x90, 0xC4, 0xB1, 0xCC, 0xD2, 0xD4, 0xF7, 0xFD, 0x98, 0x86, 0xA9, 0x8A, 0xFB, 0x9E, 0x8D,
+    0xA3, 0x97, 0xE5, 0xB9, 0xAF, 0xCA, 0xF1, 0xDE, 0x92, 0xE3, 0xB7, 0xA5, 0xD8, 0xEF, 0xE8, 0xB0,
+    0xB9, 0xD1, 0xCB, 0xF3, 0xDC, 0x94, 0xE5, 0xBD, 0xAF, 0xC6, 0xF1, 0xCA, 0x92, 0xDF, 0xB7, 0xE1,
+    0xD8, 0xA3, 0xE9, 0xE4, 0xBB, 0xAD, 0xCC, 0xF7, 0xD4, 0x98, 0xFD, 0xA9, 0x87, 0xFA, 0x89, 0x8E,
+    0x9A, 0x92, 0xAE, 0xB6, 0xF2, 0xDA, 0x96, 0xEF, 0xBB, 0xB1, 0xCC, 0xD3, 0xD4, 0xF4, 0xFD, 0x9D,
+    0x86, 0xA6, 0x8A, 0xEA, 0x9E, 0xBE, 0xA3, 0xC2, 0xE5, 0xC6, 0xAE, 0xCB, 0xF3, 0xDD, 0x94, 0xE6,
+    0xBD, 0xAA, 0xC6, 0xFE, 0xCA, 0x83, 0xDF, 0x84, 0xE1, 0x8D, 0xA3, 0x96, 0xE5, 0xBA, 0xAF, 0xCF,
+    0xF1, 0xD1, 0x92, 0xF2, 0xB7, 0x96, 0xD8, 0xBA, 0xE8, 0xCF, 0xB8, 0xD0, 0xC9, 0xF0, 0xDA, 0x91,
+    0xEF, 0xB2, 0xB1, 0xD7, 0xD3, 0xF9, 0xF4, 0x8A, 0x9D, 0x9F, 0xA7, 0xA1, 0xE9, 0xE3, 0xBB, 0xA4,
+    0xCC, 0xEC, 0xD4, 0xB5, 0xFD, 0xDE, 0x87, 0xE3, 0x88, 0xA5, 0x99, 0xEF, 0xAB, 0xB1, 0xFC, 0xD3,
+    0x84, 0xF4, 0x8D, 0x9C, 0x96, 0xA4, 0xBA, 0xEC, 0xCE, 0xB4, 0xD3, 0xDD, 0xF5, 0xE6, 0x9E, 0xAB,
+    0xA3, 0xFD, 0xE5, 0x87, 0xAE, 0x88, 0xF2, 0x98, 0x96, 0xA9, 0xBA, 0xFB, 0xCE, 0x8D, 0xD3, 0x96,
+    0xF5, 0xBB, 0x9F, 0xCC, 0xA1, 0xD4, 0xE2, 0xFC, 0xA7, 0x85, 0xE8, 0x8F, 0xB8, 0x90, 0xC8, 0xB0,
+    0xD8, 0xD1, 0xE8, 0xF2, 0xB9, 0x97, 0xCA, 0xB9, 0xDE, 0xCA, 0xE2, 0xDF, 0xA7, 0xE0, 0xE8, 0xA0,
+    0xB9, 0xE1, 0xCB, 0xA3, 0xDC, 0xE4, 0xE4, 0xAD, 0xAD, 0xF6, 0xF7, 0x9A, 0x98, 0xAF, 0xA8, 0xF1,
+    0xF8, 0x93, 0x89, 0xB4, 0x9B, 0xDC, 0xAD, 0xE4, 0xF6, 0xAC, 0x9B, 0xF5, 0xAD, 0x9F, 0xF6, 0xA1,
+    0x9A, 0xE2, 0xAE, 0xA6, 0xF3, 0xEA, 0x95, 0xBF, 0xBE, 0xC1, 0xC2, 0xC3, 0xC7, 0xC4, 0xC8, 0xCD,
+    0xD9, 0xD6, 0xEA, 0xFB, 0xBF, 0x8C, 0xC0, 0x94, 0xC0, 0xBD, 0xC0, 0xC6, 0xC0, 0xCB, 0xC1, 0xDC,
+    0xC2, 0xE5, 0xC7, 0xAE, 0xC8, 0xF3, 0xD8, 0x94, 0xE9, 0xBD, 0xBB, 0xC6, 0xCD, 0xCA, 0xD6, 0xDF,
+    0xFB, 0xE0, 0x8C, 0xA1, 0x95, 0xE3, 0xBF, 0xA5, 0xC0, 0xEF, 0xC0, 0xB0, 0xC1, 0xD1, 0xC3, 0xF2,
+    0xC4, 0x97, 0xCD, 0xB8, 0xD7, 0xC9, 0xF9, 0xDA, 0x8A, 0xEF, 0x9F, 0xB1, 0xA0, 0xD3, 0xE0, 0xF5,
+    0xA1, 0x9E, 0xE2, 0xA2, 0xA6, 0xE7, 0xEA, 0xA9, 0xBF, 0xFA, 0xC1, 0x8E, 0xC2, 0x93, 0xC6, 0xB4,
+    0xCA, 0xDD, 0xDE, 0xE6, 0xE3, 0xAB, 0xA4, 0xFC, 0xEC, 0x84, 0xB5, 0x8D, 0xDF, 0x97, 0xE1, 0xB8,
+    0xA3, 0xC9, 0xE5, 0xDB, 0xAE, 0xEC, 0xF3, 0xB4, 0x94, 0xDD, 0xBC, 0xE7, 0xC5, 0xA9, 0xCE, 0xFA,
+    0xD2, 0x8F, 0xF7, 0x90, 0x99, 0xB1, 0xAB, 0xD3, 0xFD, 0xF5, 0x86, 0x9E, 0x8B, 0xA2, 0x9D, 0xE6,
+    0xA7, 0xAA, 0xE8, 0xFE, 0xB8, 0x83, 0xC9, 0x85, 0xDB, 0x8E, 0xED, 0x93, 0xB7, 0xB4, 0xD9, 0xDC,
+    0xEB, 0xE5, 0xBC, 0xAE, 0xC5, 0xF2, 0xCF, 0x97, 0xD0, 0xB8, 0xF0, 0xC9, 0x90, 0xDA, 0xB1, 0xEE,
+    0xD2, 0xB2, 0xF7, 0xD7, 0x99, 0xF8, 0xAA, 0x88, 0xFF, 0x98, 0x81, 0xA9, 0x83, 0xFB, 0x85, 0x8D,
+    0x8E, 0x97, 0x92, 0xB9, 0xB6, 0xCB, 0xDA, 0xDD, 0xEF, 0xE6, 0xB0, 0xAB, 0xD1, 0xFD, 0xF3, 0x86,
+    0x94, 0x8B, 0xBC, 0x9D, 0xC4, 0xA7, 0xCC, 0xE8, 0xD4, 0xB9, 0xFD, 0xCA, 0x87, 0xDF, 0x88, 0xE1,
+    0x99, 0xA3, 0xAA, 0xE5, 0xFE, 0xAF, 0x83, 0xF0, 0x85, 0x90, 0x8E, 0xB0, 0x92, 0xD0, 0xB6, 0xF0,
+    0xDB, 0x90, 0xEC, 0xB1, 0xB4, 0xD2, 0xDC, 0xF6, 0xE5, 0x9B, 0xAE, 0xAC, 0xF2, 0xF4, 0x96, 0x9D,
+    0xBB, 0xA7, 0xCD, 0xE9, 0xD7, 0xBA, 0xF8, 0xCF, 0x88, 0xD0, 0x99, 0xF0, 0xAA, 0x90, 0xFF, 0xB0,
+    0x81, 0xD1, 0x83, 0xF3, 0x84, 0x95, 0x8D, 0xBF, 0x97, 0xC1, 0xB9, 0xC3, 0xCA, 0xC5, 0xDF, 0xCE,
+    0xE0, 0xD3, 0xA1, 0xF4, 0xE2, 0x9C, 0xA7, 0xA5, 0xE9, 0xEF, 0xBB, 0xB0, 0xCC, 0xD0, 0xD4, 0xF1,
+    0xFD, 0x92, 0x86, 0xB7, 0x8A, 0xD9, 0x9E, 0xEB, 0xA3, 0xBD, 0xE4, 0xC7, 0xAC, 0xC8, 0xF5, 0xD8,
+    0x9E, 0xE9, 0xA3, 0xBB, 0xE4, 0xCD, 0xAC, 0xD6, 0xF5, 0xFA, 0x9E, 0x8F, 0xA3, 0x91, 0xE5, 0xB3,
+    0xAF, 0xD4, 0xF1, 0xFC, 0x92, 0x85, 0xB7, 0x8F, 0xD9, 0x91, 0xEB, 0xB2, 0xBD, 0xD7, 0xC7, 0xF9,
+    0xC8, 0x8A, 0xD9, 0x9F, 0xEB, 0xA0, 0xBD, 0xE1, 0xC7, 0xA3, 0xC8, 0xE4, 0xD8, 0xAD, 0xE9, 0xF6,
+    0xBB, 0x9B, 0xCC, 0xAD, 0xD4, 0xF6, 0xFC, 0x9B, 0x85, 0xAC, 0x8F, 0xF4, 0x91, 0x9C, 0xB2, 0xA4,
+    0xD6, 0xEC, 0xFA, 0xB5, 0x8F, 0xDE, 0x91, 0xE2, 0xB2, 0xA6, 0xD7, 0xEA, 0xF9, 0xBF, 0x8A, 0xC0,
+    0x9E, 0xC0, 0xA3, 0xC0, 0xE4, 0xC0, 0xAD, 0xC1, 0xF6, 0xC3, 0x9B, 0xC4, 0xAC, 0xCC, 0xF5, 0xD4,
+    0x9E, 0xFD, 0xA3, 0x87, 0xE4, 0x89, 0xAC, 0x9A, 0xF4, 0xAE, 0x9C, 0xF3, 0xA4, 0x95, 0xED, 0xBF,
+    0xB7, 0xC0, 0xD9, 0xC0, 0xEA, 0xC1, 0xBF, 0xC2, 0xC0, 0xC6, 0xC1, 0xCB, 0xC2, 0xDC, 0xC7, 0xE5,
+    0xC8, 0xAE, 0xD9, 0xF3, 0xEB, 0x94, 0xBC, 0xBD, 0xC4, 0xC7, 0xCC, 0xC8, 0xD5, 0xD9, 0xFE, 0xEA,
+    0x83, 0xBF, 0x84, 0xC1, 0x8C, 0xC3, 0x95, 0xC5, 0xBE, 0xCF, 0xC3, 0xD1, 0xC4, 0xF2, 0xCD, 0x97,
+    0xD6, 0xB8, 0xFA, 0xC9, 0x8E, 0xDA, 0x93, 0xEE, 0xB4, 0xB2, 0xDD, 0xD6, 0xE7, 0xFB, 0xA8, 0x8C,
+    0xF9, 0x94, 0x8B, 0xBD, 0x9D, 0xC7, 0xA7, 0xC9, 0xE8, 0xDB, 0xB9, 0xEC, 0xCA, 0xB4, 0xDF, 0xDD,
+    0xE1, 0xE6, 0xA2, 0xAB, 0xE7, 0xFD, 0xA9, 0x86, 0xFA, 0x8A, 0x8E, 0x9F, 0x92, 0xA1, 0xB6, 0xE3,
+    0xDA, 0xA5, 0xEF, 0xEE, 0xB1, 0xB3, 0xD2, 0xD5, 0xF6, 0xFE, 0x9B, 0x83, 0xAC, 0x85, 0xF4, 0x8F,
+    0x9C, 0x90, 0xA4, 0xB0, 0xEC, 0xD0, 0xB4, 0xF1, 0xDD, 0x93, 0xE6, 0xB4, 0xAA, 0xDD, 0xFE, 0xE7,
+    0x83, 0xA8, 0x84, 0xF8, 0x8C, 0x88, 0x95, 0x98, 0xBF, 0xA8, 0xC1, 0xF8, 0xC3, 0x89, 0xC4, 0x9A,
+    0xCC, 0xAF, 0xD4, 0xF0, 0xFC, 0x91, 0x85, 0xB2, 0x8F, 0xD6, 0x91, 0xFA, 0xB2, 0x8E, 0xD7, 0x92,
+    0xF9, 0xB7, 0x8B, 0xD8, 0x9D, 0xE8, 0xA6, 0xB8, 0xEB, 0xC8, 0xBD, 0xD9, 0xC6, 0xEB, 0xCB, 0xBC,
+    0xDC, 0xC5, 0xE4, 0xCE, 0xAD, 0xD3, 0xF6, 0xF5, 0x9B, 0x9E, 0xAC, 0xA2, 0xF4, 0xE6, 0x9C, 0xAB,
+    0xA5, 0xFD, 0xEF, 0x87, 0xB0, 0x88, 0xD0, 0x98, 0xF0, 0xA9, 0x90, 0xFA, 0xB0, 0x8E, 0xD1, 0x92,
+    0xF3, 0xB7, 0x95, 0xD8, 0xBF, 0xE8, 0xC0, 0xB8, 0xC1, 0xC9, 0xC3, 0xDA, 0xC4, 0xEF, 0xCD, 0xB0,
+    0xD6, 0xD1, 0xFA, 0xF2, 0x8F, 0x97, 0x90, 0xB9, 0xB0, 0xCB, 0xD0, 0xDD, 0xF1, 0xE6, 0x92, 0xAB,
+    0xB7, 0xFD, 0xD9, 0x87, 0xEA, 0x88, 0xBE, 0x99, 0xC2, 0xAB, 0xC6, 0xFC, 0xCA, 0x85, 0xDF, 0x8E,
+    0xE1, 0x93, 0xA3, 0xB4, 0xE5, 0xDC, 0xAF, 0xE5, 0xF0, 0xAF, 0x91, 0xF0, 0xB3, 0x90, 0xD4, 0xB0,
+    0xFC, 0xD1, 0x84, 0xF2, 0x8D, 0x96, 0x96, 0xBA, 0xBA, 0xCE, 0xCE, 0xD2, 0xD3, 0xF7, 0xF4, 0x98,
+    0x9D, 0xA9, 0xA7, 0xFB, 0xE9, 0x8D, 0xBA, 0x96, 0xCE, 0xBA, 0xD2, 0xCF, 0xF6, 0xD0, 0x9B, 0xF1,
+    0xAC, 0x93, 0xF5, 0xB5, 0x9F, 0xDE, 0xA1, 0xE2, 0xE2, 0xA6, 0xA7, 0xEB, 0xE9, 0xBD, 0xBA, 0xC6,
+    0xCE, 0xCA, 0xD3, 0xDF, 0xF4, 0xE0, 0x9D, 0xA1, 0xA6, 0xE3, 0xEA, 0xA5, 0xBF, 0xEE, 0xC1, 0xB2,
+    0xC2, 0xD7, 0xC6, 0xF8, 0xCB, 0x89, 0xDC, 0x9A, 0xE4, 0xAF, 0xAC, 0xF0, 0xF4, 0x90, 0x9D, 0xB1,
+    0xA7, 0xD3, 0xE9, 0xF5, 0xBA, 0x9E, 0xCF, 0xA2, 0xD1, 0xE7, 0xF3, 0xA8, 0x94, 0xF9, 0xBC, 0x8B,
+    0xC5, 0x9D, 0xCF, 0xA6, 0xD1, 0xEB, 0xF3, 0xBC, 0x94, 0xC5, 0xBC, 0xCF, 0xC5, 0xD1, 0xCE, 0xF2,
+    0xD3, 0x97, 0xF4, 0xB8, 0x9C, 0xC9, 0xA4, 0xDB, 0xED, 0xED, 0xB6, 0xB6, 0xDB, 0xDA, 0xED, 0xEF,
+    0xB6, 0xB0, 0xDB, 0xD0, 0xED, 0xF1, 0xB6, 0x92, 0xDB, 0xB6, 0xED, 0xDB, 0xB7, 0xEC, 0xD8, 0xB4,
+    0xE9, 0xDD, 0xBB, 0xE6, 0xCC, 0xAA, 0xD5, 0xFF, 0xFF,
+    0x00
+};
+
+const uint8_t noise_table_short[94] PROGMEM = {
+    0x80, 0x80, 0x81, 0x84, 0x92, 0xC0, 0xA4, 0x92, 0x80, 0xA4, 0x90, 0x89, 0x84, 0x82, 0x80, 0x84,
+    0x90, 0xC8, 0x80, 0x92, 0xC9, 0x80, 0x90, 0xC1, 0xA4, 0x90, 0x88, 0x80, 0x90, 0xC0, 0xA0, 0x82,
+    0xC8, 0xA4, 0x82, 0xC0, 0x84, 0x92, 0xC1, 0xA0, 0x80, 0xC0, 0x80, 0x82, 0x89, 0xA0, 0x92, 0x89,
+    0x80, 0x92, 0xC8, 0x84, 0x82, 0x81, 0x80, 0x82, 0x88, 0xA4, 0x80, 0xC9, 0xA4, 0x80, 0xC8, 0xA0,
+    0x92, 0x88, 0x84, 0x80, 0x88, 0xA0, 0x90, 0x81, 0xA4, 0x92, 0x81, 0xA0, 0x82, 0xC9, 0xA0, 0x90,
+    0x80, 0xA0, 0x80, 0xC1, 0x84, 0x90, 0xC9, 0x84, 0x80, 0x89, 0xA4, 0x82, 0xC1,
+    0x00
+};
@@ -0,0 +1,10 @@
+#ifndef NOISE_TABLE_H_
+#define NOISE_TABLE_H_
+
+// Output of the noise shift register in long and short mode, packed seven
+// bits to a byte and ended by a zero byte. See scripts/make_noise_table.cpp.
+
+extern const uint8_t noise_table_long[4682] PROGMEM;
+extern const uint8_t noise_table_short[94] PROGMEM;
+
+#endif
@@ -3,6 +3,8 @@
 
 #ifndef __ASSEMBLER__
 
+#ifndef DUAL_CHANNEL
+
 // Square + Noise
 register uint8_t channel_volume asm("r2");
 // Triangle
@@ -11,14 +13,36 @@ register uint8_t channel_volume asm("r2");
 // Square + Noise + Triangle
 register uint8_t channel_length_counter asm("r3");
 
-// Noise
-register uint8_t shift_register_lo asm("r4");
-register uint8_t shift_register_hi asm("r5");
+// Noise: bits of noise_table_*.c left to play and the next byte to load
+register uint8_t noise_bits asm("r4");
+register const uint8_t *noise_ptr asm("r8");
 
 // Square
-#define channel_duty_cycle shift_register_lo
+#define channel_duty_cycle noise_bits
 // Square + Triangle
-#define channel_step shift_register_hi
+register uint8_t channel_step asm("r5");
+
+// All: the DAC pins of PINS_DAC_PORT for the next sample, see interrupt.asm
+register uint8_t channel_output asm("r7");
+
+#else
+
+// Dual channel firmware, see dual.c: channel 0 on PINS_DAC_PORT and channel 1
+// on PINS_DAC_B_PORT. The interval is the number of timer ticks between two
+// samples, and the volume of channel 1 is shifted to the pins of its DAC.
+register uint8_t dual_volume0 asm("r2");
+register uint8_t dual_duty_cycle0 asm("r4");
+register uint8_t dual_step0 asm("r5");
+register uint8_t dual_output0 asm("r7");
+register uint16_t dual_interval0 asm("r8");
+
+register uint8_t dual_volume1 asm("r10");
+register uint8_t dual_duty_cycle1 asm("r11");
+register uint8_t dual_step1 asm("r12");
+register uint8_t dual_output1 asm("r13");
+register uint16_t dual_interval1 asm("r14");
+
+#endif
 
 #else
 
@@ -27,15 +51,34 @@ register uint8_t shift_register_hi asm("r5");
 #define channel_length_counter r3
 #define channel_duty_cycle     r4
 #define channel_step           r5
-#define shift_register_lo      r4
-#define shift_register_hi      r5
+#define channel_output         r7
+#define noise_bits             r4
+#define noise_ptr_lo           r8
+#define noise_ptr_hi           r9
 
 #define temp2                  r6
 
+#define dual_volume0           r2
+#define dual_sreg              r3
+#define dual_duty_cycle0       r4
+#define dual_step0             r5
+#define dual_output0           r7
+#define dual_interval0_lo      r8
+#define dual_interval0_hi      r9
+#define dual_volume1           r10
+#define dual_duty_cycle1       r11
+#define dual_step1             r12
+#define dual_output1           r13
+#define dual_interval1_lo      r14
+#define dual_interval1_hi      r15
+
 #endif
 
 #define channel_shift_mode GPIOR0
 #define channel_conf       GPIOR0
 #define frame_flag         GPIOR0
+#define bus_error_flag     GPIOR0
+
+#define bus_head           GPIOR1
 
 #endif
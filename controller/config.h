@@ -17,6 +17,9 @@
 #define LOG_USE_SSD1306
 #define LOG_USE_BUF
 
+// Log the SD read speed at startup
+// #define SD_BENCHMARK
+
 
 //// Pins /////////////////////////////////////////////////////////////////////
 
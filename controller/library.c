@@ -0,0 +1,51 @@
+#include <avr/pgmspace.h>
+
+#include <string.h>
+
+#include "config.h"
+#include "fat32.h"
+#include "log.h"
+#include "menu.h"
+#include "library.h"
+
+struct library_t library;
+
+uint8_t library_init()
+{
+    memset(&library, 0, sizeof(library));
+
+    fat32_open_root_dir();
+    if(!fat32_open_file(LIBRARY_NAME, MENU_EXT))
+    {
+        return 0;
+    }
+
+    fat32_read(&library, sizeof(library));
+    fat32_close_file();
+
+    if(memcmp_P(library.magic, PSTR("NLIB"), 4) || library.record_len != LIBRARY_RECORD_LEN)
+    {
+        log_puts_P(PSTR("Unknown library format\n"));
+        library.num_letters = 0;
+        return 0;
+    }
+
+    log_puts_P(PSTR("Library games: "));
+    log_put_uint16(library.num_games);
+    log_puts_P(PSTR("\nLibrary tracks: 0x"));
+    log_put_uint32_hex(library.num_tracks);
+    log_nl();
+
+    return 1;
+}
+
+void library_read_entry(uint32_t table, uint32_t num, struct library_entry_t *entry)
+{
+    fat32_open_root_dir();
+    fat32_open_file(LIBRARY_NAME, MENU_EXT);
+
+    fat32_seek(table + num * LIBRARY_RECORD_LEN);
+    fat32_read(entry, sizeof(*entry));
+
+    fat32_close_file();
+}
@@ -0,0 +1,48 @@
+#ifndef LIBRARY_H_
+#define LIBRARY_H_
+
+// Binary song library on the SD card, LIBRARY.MNU, written by
+// scripts/make_library. It holds three tables of fixed length records:
+// letters, games sorted by title and tracks grouped by game. A letter points
+// to a range of games and a game to a range of tracks, so every level can be
+// shown as a menu starting at any record.
+
+#define LIBRARY_NAME "LIBRARY"
+#define LIBRARY_RECORD_LEN 32
+#define LIBRARY_TITLE_LEN 20
+
+// The header at the start of the file
+struct library_t
+{
+    char magic[4]; // "NLIB"
+    uint16_t record_len;
+    uint16_t num_letters;
+    uint16_t num_games;
+    uint16_t reserved;
+    uint32_t num_tracks;
+    uint32_t letter_table; // File offsets of the tables
+    uint32_t game_table;
+    uint32_t track_table;
+};
+
+struct library_entry_t
+{
+    char title[LIBRARY_TITLE_LEN];
+    union
+    {
+        struct // Letters and games
+        {
+            uint32_t first; // First record in the table of the next level
+            uint16_t count;
+        };
+        char filename[8]; // Tracks: song file without extension, padded with spaces
+    };
+    uint8_t reserved[4];
+};
+
+extern struct library_t library;
+
+uint8_t library_init();
+void library_read_entry(uint32_t table, uint32_t num, struct library_entry_t *entry);
+
+#endif
@@ -1,27 +1,33 @@
 /************************************************************************
  * Main controller
  *
- * The main playing loop reads data from the SD card into two circular
- * buffer (one with addresses and one with data values), and handles
- * user input
+ * The main playing loop reads data from the SD card into a circular
+ * buffer of (address, value) pairs, and handles user input once a few
+ * complete frames are buffered
  *
  * Playback is performed using two timers:
  *
  * - Timer 0 fires at 240 Hz
  *   and outputs the frame clock. At every four frames it starts timer 2
- *   to output data
+ *   to output data, if a complete frame is buffered
  *
  * - Timer 1 fires at 8 Hz and increments global_timer
  *
- * - Timer 2 fires at around 60 kHz. It outputs the data from the address
- *   and value buffers to the bus, and stops itself once it finds the end
- *   of frame marker
+ * - Timer 2 fires once after it has been started. It outputs the data
+ *   from the buffer to the bus back to back, with interrupts enabled,
+ *   until it finds the end of frame marker
+ *
+ * The bus has no way to answer, so each phase of a write is held for a
+ * fixed time, bus_strobe, long enough for the channels to read it. The
+ * "Calibrate bus" menu finds the shortest time that works and stores it
+ * in the EEPROM.
  ************************************************************************/
 
 
 #include <avr/io.h>
 #include <avr/pgmspace.h>
 #include <util/delay.h>
+#include <util/delay_basic.h>
 #include <avr/interrupt.h>
 #include <avr/eeprom.h>
 
@@ -37,7 +43,10 @@
 #include "log.h"
 #include "io-bridge.h"
 #include "menu.h"
+#include "library.h"
 #include "cbuf.h"
+#include "bus.h"
+#include "song.h"
 
 #include "ssd1306-internal.h"
 #include "ssd1306-cmd.h"
@@ -45,22 +54,44 @@
 #include "logo-paw-48x48.h"
 #include <string.h>
 
-#define reg_address_LEN 128
-#define reg_data_LEN 128
+#define song_buf_LEN 128
 
-struct
+struct reg_write_t
 {
-    volatile uint8_t head;
-    volatile uint8_t tail;
-    volatile uint8_t buf[reg_address_LEN];
-} reg_address;
+    uint8_t address;
+    uint8_t value;
+};
 
+// Register writes read from the song, waiting to be put on the bus
 struct
 {
     volatile uint8_t head;
     volatile uint8_t tail;
-    volatile uint8_t buf[reg_data_LEN];
-} reg_data;
+    volatile struct reg_write_t buf[song_buf_LEN];
+} song_buf;
+
+// End of frame markers pushed to and popped from song_buf, their difference
+// is the number of complete frames in the buffer
+volatile uint8_t song_frames_in;
+volatile uint8_t song_frames_out;
+
+// Playback statistics of the current song, logged when it stops
+volatile uint16_t song_underruns;   // Frame clocks with no complete frame buffered
+volatile uint16_t song_late_frames; // Frame clocks while the previous frame was still being sent
+volatile uint8_t song_min_frames;   // Fewest complete frames buffered at a frame clock
+
+// Each register write is an address phase with DCLK high followed by a value
+// phase with DCLK low, and each phase lasts bus_strobe delay loops of 3
+// cycles plus a few cycles of overhead. The channels need 60-70 cycles to
+// read a phase in the worst case, when their timer interrupt is running.
+#define BUS_STROBE_DEFAULT 40
+#define BUS_STROBE_MIN 1
+
+// Settings after the playlist in the EEPROM: the strobe and its complement
+#define BUS_STROBE_EEPROM_ADDR (8 * MENU_EEPROM_MAX_ITEMS)
+
+uint8_t bus_strobe = BUS_STROBE_DEFAULT;
+volatile uint8_t bus_busy; // Set from timer2_start() until the frame has been sent
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -78,6 +109,10 @@ static inline void timer0_stop();
 static inline void timer2_start();
 static inline void timer2_stop();
 
+static inline void bus_write(uint8_t address, uint8_t value);
+void bus_load_strobe();
+void bus_calibrate();
+
 void error_led_loop();
 
 void i2c_scan();
@@ -117,18 +152,21 @@ static const uint8_t copyright_c[] PROGMEM = { 0x3C, 0x42, 0x99, 0xA5, 0xA5, 0x8
 static const char copyright[] PROGMEM = COPYRIGHT_YEAR " " AUTHOR;
 
 static const char menu_name_cat[8] PROGMEM = "CAT";
+static const char menu_name_library[8] PROGMEM = LIBRARY_NAME;
 
 static const char menu_main_entry_0[] PROGMEM = "Songs sorted by game";
 static const char menu_main_entry_1[] PROGMEM = "Play playlist";
 static const char menu_main_entry_2[] PROGMEM = "Edit playlist";
 static const char menu_main_entry_3[] PROGMEM = "Log";
-static const char menu_main_entry_4[] PROGMEM = "About";
+static const char menu_main_entry_4[] PROGMEM = "Calibrate bus";
+static const char menu_main_entry_5[] PROGMEM = "About";
 
 #define MENU_MAIN_SONGS_SORTED_BY_GAME 0
 #define MENU_MAIN_PLAY_PLAYLIST 1
 #define MENU_MAIN_EDIT_PLAYLIST 2
 #define MENU_MAIN_LOG 3
-#define MENU_MAIN_ABOUT 4
+#define MENU_MAIN_CALIBRATE_BUS 4
+#define MENU_MAIN_ABOUT 5
 
 static const char* const menu_main_entries[] PROGMEM = {
     menu_main_entry_0,
@@ -136,6 +174,7 @@ static const char* const menu_main_entries[] PROGMEM = {
     menu_main_entry_2,
     menu_main_entry_3,
     menu_main_entry_4,
+    menu_main_entry_5,
 };
 
 static const char menu_playlist_edit_entry_0[] PROGMEM = "Add Track";
@@ -155,6 +194,9 @@ static const char* const menu_playlist_edit_entries[] PROGMEM = {
 
 struct menu_info_t menu_main_info;
 struct menu_info_t menu_game_info;
+struct menu_info_t menu_letter_info;
+struct menu_info_t menu_library_game_info;
+struct menu_info_t menu_track_info;
 struct menu_info_t menu_playlist_info;
 struct menu_info_t menu_playlist_edit_info;
 
@@ -201,6 +243,7 @@ void io_init()
 void spi_init()
 {
   // Enable SPI as master, MSB first, clock rate f_osc/16
+  // sd_init() switches to f_osc/2 when the card has been initialised
     SPCR |= _BV(MSTR) | _BV(SPE) |  (0 << SPR1) | (1 << SPR0);
 
   // Clear double speed
@@ -291,6 +334,8 @@ static inline void timer0_stop()
 
 static inline void timer2_start()
 {
+    bus_busy = 1;
+    TCNT2 = 0;
     TCCR2B |= _BV(CS21); // Prescaler 8
 }
 
@@ -314,7 +359,34 @@ void timers_init()
     TCCR2A = _BV(WGM21); // CTC mode
     TCCR2B = 0;
     TIMSK2 |= _BV(OCIE2A); // Set interrupt on compare match
-    OCR2A = 59; // Interrupt every ~ 33 us
+    OCR2A = 15; // Start sending ~ 9 us after timer2_start(), well after the interrupt has stopped the timer
+}
+
+static inline void bus_write(uint8_t address, uint8_t value)
+{
+    PINS_BUS_PORT = address;
+    set_high(PIN_DCLK);
+    _delay_loop_1(bus_strobe);
+
+    PINS_BUS_PORT = value;
+    set_low(PIN_DCLK);
+    _delay_loop_1(bus_strobe);
+}
+
+void bus_load_strobe()
+{
+    uint8_t strobe = eeprom_read_byte((const uint8_t*)BUS_STROBE_EEPROM_ADDR);
+    uint8_t check = eeprom_read_byte((const uint8_t*)(BUS_STROBE_EEPROM_ADDR + 1));
+
+    // Keep the default on an erased EEPROM
+    if(strobe && (uint8_t)~strobe == check)
+    {
+        bus_strobe = strobe;
+    }
+
+    log_puts_P(PSTR("Bus strobe: "));
+    log_put_uint8(bus_strobe);
+    log_nl();
 }
 
 void song_open(const char* filename)
@@ -325,6 +397,11 @@ void song_open(const char* filename)
     {
         song_done = 0;
 
+        song_frames_in = song_frames_out = 0;
+        song_underruns = 0;
+        song_late_frames = 0;
+        song_min_frames = 0xFF;
+
         log_puts("Playing \"");
         log_puts(filename);
         log_puts("\"\n");
@@ -368,54 +445,167 @@ void error_led_loop()
     }
 }
 
+// Complete frames to keep buffered before spending time on anything else
+#define SONG_PREFETCH_FRAMES 4
+
+static inline void song_buf_push(uint8_t address, uint8_t value)
+{
+    volatile struct reg_write_t *w = &song_buf.buf[song_buf.head & (song_buf_LEN - 1)];
+
+    w->address = address;
+    w->value = value;
+    song_buf.head++;
+}
+
+static inline uint8_t song_buf_frames()
+{
+    return song_frames_in - song_frames_out;
+}
+
+static void song_read_push(uint8_t address, uint8_t value)
+{
+    song_buf_push(address, value);
+
+    if(address == 0xF1 || address == 0xFF)
+    {
+        song_frames_in++;
+    }
+}
+
+static void song_read_loop(uint32_t dest)
+{
+    log_puts("Loop to 0x");
+    log_put_uint32_hex(dest);
+    log_puts("\n");
+
+    toggle(PIN_LED);
+}
+
 void song_read_data()
 {
-    while(!cbuf_full(reg_data))
+    while(!cbuf_full(song_buf))
     {
-        uint8_t data[2];
+        uint8_t empty = cbuf_empty(song_buf);
 
-        fat32_read(data, 2); // TODO: read more than two bytes at a time!
+        if(!song_read_chunk(song_buf_LEN - cbuf_len(song_buf), song_read_push, song_read_loop))
+        {
+            break;
+        }
 
-        if(cbuf_empty(reg_data))
+        if(empty)
         {
             set_high(PIN_LED);
         }
+    }
+}
 
+#ifdef SD_BENCHMARK
 
-        if(data[0] == 0xFE)
-        {
-            fat32_read(data, 2); // TODO: read more than two bytes at a time!
-            uint16_t dest = ((uint16_t)data[0]<<8) | data[1];
-            log_puts("Loop to 0x");
-            log_put_uint16_hex(dest);
-            log_puts("\n");
+#define SD_BENCHMARK_SECTORS 64
+
+// Timer 1 ticks, of 1024 cycles each, since startup
+static uint32_t timer1_ticks()
+{
+    cli();
+    uint16_t ticks = TCNT1;
+    uint16_t timer = global_timer;
 
+    // The counter has wrapped but the interrupt has not run yet
+    if((TIFR1 & _BV(OCF1A)) && ticks < OCR1A / 2)
+    {
+        timer++;
+    }
+    sei();
 
-            toggle(PIN_LED);
+    return (uint32_t)timer * (OCR1A + 1) + ticks;
+}
 
-            fat32_seek(dest);
-        } else {
-            cbuf_push(reg_address, data[0]);
-            cbuf_push(reg_data, data[1]);
+static void sd_benchmark_log(const char *name_p, uint32_t ticks)
+{
+    const uint32_t bytes = SD_BENCHMARK_SECTORS * 512UL;
+
+    log_puts_P(name_p);
+    log_put_uint16(ticks * 1024 / bytes);
+    log_puts_P(PSTR(" cyc/B "));
+    log_put_uint16(bytes * (F_CPU / 1024) / ticks / 1024);
+    log_puts_P(PSTR(" KB/s\n"));
+}
+
+// Read the first sectors of the card a byte at a time, like fat32_read() used
+// to, in blocks, and in blocks with a multiple block read, and log the CPU cycles per byte (16 for a saturated bus)
+void sd_benchmark()
+{
+    uint8_t buf[SONG_READ_CHUNK];
+    uint32_t start;
+
+    start = timer1_ticks();
+    for(uint8_t n = 0; n < SD_BENCHMARK_SECTORS; n++)
+    {
+        sd_begin_sector(n);
+        while(!sd_sector_done())
+        {
+            sd_read_uint8();
+        }
+        sd_end_sector();
+    }
+    sd_benchmark_log(PSTR("Byte:  "), timer1_ticks() - start);
+
+    start = timer1_ticks();
+    for(uint8_t n = 0; n < SD_BENCHMARK_SECTORS; n++)
+    {
+        sd_begin_sector(n);
+        while(sd_read_block(buf, sizeof(buf)))
+        {
+        }
+        sd_end_sector();
+    }
+    sd_benchmark_log(PSTR("Block: "), timer1_ticks() - start);
+
+    start = timer1_ticks();
+    for(uint8_t n = 0; n < SD_BENCHMARK_SECTORS; n++)
+    {
+        sd_stream_sector(n);
+        while(sd_read_block(buf, sizeof(buf)))
+        {
         }
     }
+    sd_end_sector();
+    sd_benchmark_log(PSTR("Stream:"), timer1_ticks() - start);
 }
 
+#endif
+
+// Sends a frame that silences every channel, and waits until it has gone
+// out, as the frame clock only sends frames while a song is playing
 void reset_channels()
 {
+    while(bus_busy)
+        ;
+
     cli();
-    cbuf_init(reg_address);
-    cbuf_init(reg_data);
+    cbuf_init(song_buf);
+    song_frames_in = song_frames_out;
+
+    for(uint8_t n = 0; n <= BUS_APU_FRAME; n++)
+    {
+        song_buf_push(n, 0);
+    }
 
-    for(uint8_t n = 0; n <= 0x17; n++)
+    // Disables the pulses and the saw of any VRC6 boards
+    for(uint8_t n = 0; n < 3; n++)
     {
-        cbuf_push(reg_address, n);
-        cbuf_push(reg_data, 0);
+        song_buf_push(BUS_VRC6 + 4 * n + 2, 0);
     }
 
+    song_buf_push(0xF1, 0);
+    song_frames_in++;
+
     sei();
 
     timer2_start();
+
+    while(bus_busy)
+        ;
 }
 
 // maximum play time for each song in units of 1/8 s
@@ -431,16 +621,36 @@ uint8_t song_play(const char* filename)
 
     uint8_t ret;
 
-    while(!(ret = song_handle_inputs()) && !song_done)
+    ret = 0;
+
+    while(!ret && !song_done)
     {
         song_read_data();
 
+        // Reading the buttons over I2C can take a while, so only do it once
+        // a few frames are buffered, or when no more fit
+        if(song_buf_frames() >= SONG_PREFETCH_FRAMES || cbuf_full(song_buf))
+        {
+            ret = song_handle_inputs();
+        }
+
         if(global_timer - start_time > MAX_PLAY_TIME)
         {
             song_done = 1  ;
         }
     }
 
+    // Keeps the frame clock from sending any more frames
+    song_done = 1;
+
+    log_puts_P(PSTR("Min buffered: "));
+    log_put_uint8(song_min_frames);
+    log_puts_P(PSTR("\nUnderruns: "));
+    log_put_uint16(song_underruns);
+    log_puts_P(PSTR("\nLate frames: "));
+    log_put_uint16(song_late_frames);
+    log_nl();
+
     reset_channels();
     _delay_ms(100); // Make sure channels have time to stop playing
     song_stop();
@@ -491,13 +701,7 @@ void category_read_info(uint8_t choice, char *catname, uint8_t *len)
     fat32_open_root_dir();
     fat32_open_file("CAT", MENU_EXT);
 
-    fat32_seek(0);
-
-    fat32_skip_until('\n'); // Skip number of lines + new line
-    for(uint8_t i = 0; i < choice; i++)
-    {
-        fat32_skip_until('\n');
-    }
+    menu_fat32_seek_entry(&menu_game_info, choice);
 
     ssd1306_text_start(0,1);
 
@@ -592,6 +796,83 @@ void category_play(uint8_t choice)
     }
 }
 
+static void library_show_track(uint16_t track, uint16_t len, const char *title)
+{
+    char str[SSD1306_LINE_WIDTH];
+
+    strcpy_P(str, PSTR("Track "));
+    utoa(track, str + strlen(str), 10);
+    strcat_P(str, PSTR("/"));
+    utoa(len, str + strlen(str), 10);
+
+    for(uint8_t i = strlen(str); i < SSD1306_LINE_WIDTH-1; i++)
+    {
+        str[i] = ' ';
+    }
+    str[SSD1306_LINE_WIDTH-1] = 0;
+
+    ssd1306_puts(str, 0, 2);
+
+    ssd1306_text_start(0,3);
+    for(uint8_t i = 0; i < LIBRARY_TITLE_LEN; i++)
+    {
+        ssd1306_text_putc(title[i]);
+    }
+    ssd1306_text_end();
+}
+
+void library_play(const struct library_entry_t *game, uint16_t track)
+{
+    ssd1306_clear();
+    ssd1306_puts("Playing:",0,0);
+
+    ssd1306_text_start(0,1);
+    for(uint8_t i = 0; i < LIBRARY_TITLE_LEN; i++)
+    {
+        ssd1306_text_putc(game->title[i]);
+    }
+    ssd1306_text_end();
+
+    uint8_t done = 0;
+
+    while(!done)
+    {
+        struct library_entry_t entry;
+        library_read_entry(library.track_table, game->first + track, &entry);
+
+        char filename[9];
+        memcpy(filename, entry.filename, 8);
+        filename[8] = 0;
+
+        library_show_track(track + 1, game->count, entry.title);
+
+        uint8_t ret = song_play(filename);
+
+        switch(ret)
+        {
+        case SONG_NEXT:
+            track++;
+            if(track >= game->count)
+            {
+                track = 0;
+            }
+            break;
+
+        case SONG_PREV:
+            if(track == 0)
+            {
+                track = game->count;
+            }
+            track--;
+            break;
+
+        case SONG_STOP:
+            done = 1;
+            break;
+        }
+    }
+}
+
 void about_show()
 {
     ssd1306_clear();
@@ -612,6 +893,147 @@ void splash_show()
 {
 }
 
+// Register writes that keep all four channels playing at short periods, so
+// that their timer interrupts fire about as often as they ever do
+static const uint8_t bus_test_init[] PROGMEM = {
+    0x15, 0x0F,
+    0x00, 0xB4, 0x02, 0x08, 0x03, 0x08, // Square 1: 50% duty, volume 4, period 8
+    0x04, 0xB4, 0x06, 0x08, 0x07, 0x08, // Square 2
+    0x08, 0xFF, 0x0A, 0x08, 0x0B, 0x08, // Triangle: period 8
+    0x0C, 0x34, 0x0E, 0x00, 0x0F, 0x08, // Noise: volume 4, shortest period
+};
+
+// Writes of the same periods again, which don't change the sound
+static const uint8_t bus_test_frame[] PROGMEM = {
+    0x02, 0x08, 0x06, 0x08, 0x0A, 0x08, 0x0E, 0x00,
+};
+
+#define BUS_TEST_FRAMES 30 // Per strobe, about half a second
+#define BUS_TEST_REPEAT 8  // Copies of bus_test_frame per frame
+
+// Send the (address, value) pairs in data_p, repeat times, as one frame
+static void bus_send_P(const uint8_t *data_p, uint8_t len, uint8_t repeat)
+{
+    while(bus_busy)
+        ;
+
+    while(repeat--)
+    {
+        for(uint8_t i = 0; i < len; i += 2)
+        {
+            song_buf_push(pgm_read_byte(&data_p[i]), pgm_read_byte(&data_p[i+1]));
+        }
+    }
+
+    song_buf_push(0xF1, 0);
+    song_frames_in++;
+
+    timer2_start();
+}
+
+// The channels can't report errors over the bus, but each one keeps its LED
+// lit once it has lost an edge. Step the strobe down from the default while
+// sending a lot of writes, until the user sees a LED stay lit and presses a
+// button, and store the strobe from before that with a margin.
+void bus_calibrate()
+{
+    ssd1306_clear();
+    ssd1306_puts_P(PSTR("Bus calibration"), 0, 0);
+    ssd1306_puts_P(PSTR("Press a button when"), 0, 2);
+    ssd1306_puts_P(PSTR("a channel LED stays"), 0, 3);
+    ssd1306_puts_P(PSTR("lit"), 0, 4);
+
+    // Resetting the channels turns their LEDs off
+    channel_reset_hold();
+    _delay_ms(10);
+    channel_reset_release();
+    _delay_ms(1500); // The channels blink their configuration at startup
+
+    while(get_input())
+        ;
+
+    uint8_t saved_strobe = bus_strobe;
+    uint8_t strobe = BUS_STROBE_DEFAULT;
+    uint8_t prev_strobe = strobe;
+    uint8_t input = 0;
+
+    for(;;)
+    {
+        char str[SSD1306_LINE_WIDTH];
+
+        bus_strobe = strobe;
+
+        strcpy_P(str, PSTR("Strobe: "));
+        utoa(strobe, str + strlen(str), 10);
+        strcat_P(str, PSTR("  "));
+        ssd1306_puts(str, 0, 6);
+
+        bus_send_P(bus_test_init, sizeof(bus_test_init), 1);
+
+        for(uint8_t n = 0; n < BUS_TEST_FRAMES && !input; n++)
+        {
+            bus_send_P(bus_test_frame, sizeof(bus_test_frame), BUS_TEST_REPEAT);
+            _delay_ms(16);
+
+            input = get_input();
+        }
+
+        if(input || strobe == BUS_STROBE_MIN)
+        {
+            break;
+        }
+
+        prev_strobe = strobe;
+        strobe -= strobe / 8 + 1;
+
+        if(strobe < BUS_STROBE_MIN)
+        {
+            strobe = BUS_STROBE_MIN;
+        }
+    }
+
+    while(bus_busy)
+        ;
+
+    // The error may have happened during the previous step, before the LED
+    // was noticed
+    if(input)
+    {
+        strobe = prev_strobe;
+    }
+
+    if(strobe == BUS_STROBE_DEFAULT && input)
+    {
+        // Not even the default works, leave the setting alone
+        bus_strobe = saved_strobe;
+        ssd1306_puts_P(PSTR("Failed at default"), 0, 6);
+    } else {
+        bus_strobe = strobe + strobe / 2 + 1;
+
+        eeprom_update_byte((uint8_t*)BUS_STROBE_EEPROM_ADDR, bus_strobe);
+        eeprom_update_byte((uint8_t*)(BUS_STROBE_EEPROM_ADDR + 1), ~bus_strobe);
+
+        char str[SSD1306_LINE_WIDTH];
+
+        strcpy_P(str, PSTR("Saved strobe: "));
+        utoa(bus_strobe, str + strlen(str), 10);
+        ssd1306_puts(str, 0, 6);
+    }
+
+    log_puts_P(PSTR("Bus strobe: "));
+    log_put_uint8(bus_strobe);
+    log_nl();
+
+    channel_reset_hold();
+    _delay_ms(10);
+    channel_reset_release();
+    _delay_ms(1500);
+    reset_channels();
+
+    while(!get_input())
+        ;
+}
+
 extern char log_buf[LOG_BUF_LEN];
 
 void log_show()
@@ -679,14 +1101,76 @@ static void menu_init()
     menu_pgm_init(menu_playlist_edit_entries, sizeof(menu_playlist_edit_entries)/sizeof(menu_playlist_edit_entries[0]), &menu_playlist_edit_info);
     menu_fat32_init(menu_name_cat, &menu_game_info);
     menu_eeprom_init(&menu_playlist_info);
+
+    if(library_init())
+    {
+        menu_fat32_records_init(menu_name_library, library.letter_table, LIBRARY_RECORD_LEN, library.num_letters, &menu_letter_info);
+    }
+}
+
+// Letter -> game -> track menus of the library. Each level is a window onto
+// one of the tables in LIBRARY.MNU, so entering a letter or a game is a
+// single seek however large the library is.
+static void menu_library_loop(void (*action)(const struct library_entry_t *game, uint16_t track))
+{
+    for(;;)
+    {
+        uint16_t res = menu_loop(&menu_letter_info);
+        if(res & MENU_BACK_FLAG)
+            break;
+
+        struct library_entry_t letter;
+        library_read_entry(library.letter_table, res, &letter);
+
+        menu_fat32_records_init(menu_name_library, library.game_table + letter.first * LIBRARY_RECORD_LEN, LIBRARY_RECORD_LEN, letter.count, &menu_library_game_info);
+
+        for(;;)
+        {
+            res = menu_loop(&menu_library_game_info);
+            if(res & MENU_BACK_FLAG)
+                break;
+
+            struct library_entry_t game;
+            library_read_entry(library.game_table, letter.first + res, &game);
+
+            menu_fat32_records_init(menu_name_library, library.track_table + game.first * LIBRARY_RECORD_LEN, LIBRARY_RECORD_LEN, game.count, &menu_track_info);
+
+            for(;;)
+            {
+                res = menu_loop(&menu_track_info);
+                if(res & MENU_BACK_FLAG)
+                    break;
+
+                action(&game, res);
+            }
+        }
+    }
+}
+
+static void playlist_add_library_track(const struct library_entry_t *game, uint16_t track)
+{
+    struct library_entry_t entry;
+    library_read_entry(library.track_table, game->first + track, &entry);
+
+    if(menu_playlist_info.num_items < MENU_EEPROM_MAX_ITEMS)
+    {
+        eeprom_write_block(entry.filename, (void*)(8 * menu_playlist_info.num_items), 8);
+        menu_playlist_info.num_items++;
+    }
 }
 
 
 static void menu_play_category_loop()
 {
+    if(library.num_letters)
+    {
+        menu_library_loop(library_play);
+        return;
+    }
+
     for(;;)
     {
-        uint8_t res = menu_loop(&menu_game_info);
+        uint16_t res = menu_loop(&menu_game_info);
         if(res & MENU_BACK_FLAG)
                     break;
 
@@ -698,7 +1182,7 @@ static void menu_play_playlist_loop()
 {
     for(;;)
     {
-        uint8_t res = menu_loop(&menu_playlist_info);
+        uint16_t res = menu_loop(&menu_playlist_info);
         if(res & MENU_BACK_FLAG)
             break;
 
@@ -713,13 +1197,19 @@ static void menu_edit_playlist_loop()
 {
     for(;;)
     {
-        uint8_t res = menu_loop(&menu_playlist_edit_info);
+        uint16_t res = menu_loop(&menu_playlist_edit_info);
         if(res & MENU_BACK_FLAG)
             break;
 
         switch(res)
         {
         case MENU_PLAYLIST_EDIT_ADD_TRACK:
+            if(library.num_letters)
+            {
+                menu_library_loop(playlist_add_library_track);
+                break;
+            }
+
             for(;;)
             {
                 res = menu_loop(&menu_game_info);
@@ -784,7 +1274,7 @@ static void menu_edit_playlist_loop()
                 {
                     filename[6] = '0' + track / 10;
                     filename[7] = '0' + track % 10;
-                    if(menu_playlist_info.num_items < 128)
+                    if(menu_playlist_info.num_items < MENU_EEPROM_MAX_ITEMS)
                     {
                         eeprom_write_block(filename, (void*)(8 * menu_playlist_info.num_items), 8);
                         menu_playlist_info.num_items++;
@@ -801,14 +1291,19 @@ static void menu_edit_playlist_loop()
                 if(res & MENU_BACK_FLAG)
                     break;
 
-                for(uint8_t i = res; i < menu_playlist_info.num_items; i++)
+                uint8_t s[8];
+
+                for(uint8_t i = res; i + 1 < menu_playlist_info.num_items; i++)
                 {
-                    uint8_t s[8];
                     eeprom_read_block(s,(void*)((i+1)*8),8);
                     eeprom_update_block(s,(void*)(i*8),8);
                 }
 
+                // Erase the last entry rather than copying in the slot after
+                // it, which holds the settings when the playlist is full
+                memset(s, 0xFF, 8);
                 menu_playlist_info.num_items--;
+                eeprom_update_block(s,(void*)(menu_playlist_info.num_items*8),8);
             }
             break;
 
@@ -825,8 +1320,7 @@ int main()
 
     timers_init();
 
-    cbuf_init(reg_address);
-    cbuf_init(reg_data);
+    cbuf_init(song_buf);
 
     sei();
 
@@ -875,9 +1369,14 @@ int main()
     sd_init();
     fat32_init();
 
+#ifdef SD_BENCHMARK
+    sd_benchmark();
+#endif
+
 //    clear_inputs();
 
     menu_init();
+    bus_load_strobe();
 
     _delay_ms(1125);
     reset_channels();
@@ -906,6 +1405,10 @@ int main()
             log_show();
             break;
 
+        case MENU_MAIN_CALIBRATE_BUS:
+            bus_calibrate();
+            break;
+
         case MENU_MAIN_ABOUT:
             about_show();
             break;
@@ -927,10 +1430,24 @@ ISR(TIMER0_COMPA_vect) // Frame clock fires at 240 Hz
 
     if(!(cnt & 0x03))
     {
-        // Push out new data at 60 Hz
+        // Push out new data at 60 Hz, but only whole frames
         if(!song_done)
         {
-            timer2_start();
+            uint8_t frames = song_frames_in - song_frames_out;
+
+            if(frames < song_min_frames)
+            {
+                song_min_frames = frames;
+            }
+
+            if(bus_busy)
+            {
+                song_late_frames++;
+            } else if(!frames) {
+                song_underruns++;
+            } else {
+                timer2_start();
+            }
         }
     }
 
@@ -942,35 +1459,29 @@ ISR(TIMER1_COMPA_vect)
     global_timer++;
 }
 
-ISR(TIMER2_COMPA_vect) // Push out new data
+ISR(TIMER2_COMPA_vect, ISR_NOBLOCK) // Push out a frame of data
 {
-    static uint8_t n = 0;
+    timer2_stop();
 
-    if(cbuf_empty(reg_data))
+    while(!cbuf_empty(song_buf))
     {
-        timer2_stop(); // We are done for now
-    } else {
-        if(!(n++ & 0x01))
+        volatile struct reg_write_t *w = &song_buf.buf[song_buf.tail & (song_buf_LEN - 1)];
+        uint8_t address = w->address;
+        uint8_t value = w->value;
+        song_buf.tail++;
+
+        if(address == 0xFF) // End song
         {
-            uint8_t address = cbuf_pop(reg_address);
-            if(address == 0xFF) // End song
-            {
-                timer2_stop();
-                cbuf_pop(reg_data);
-                n++;
-                song_done = 1;
-            } else if(address == 0xF1) { // End frame
-                timer2_stop();
-                cbuf_pop(reg_data);
-                n++;
-            } else {
-                PINS_BUS_PORT = address;
-                set_high(PIN_DCLK);
-            }
-        } else {
-            uint8_t value = cbuf_pop(reg_data);
-            PINS_BUS_PORT = value;
-            set_low(PIN_DCLK);
+            song_frames_out++;
+            song_done = 1;
+            break;
+        } else if(address == 0xF1) { // End frame
+            song_frames_out++;
+            break;
         }
+
+        bus_write(address, value);
     }
+
+    bus_busy = 0;
 }
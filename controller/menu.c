@@ -20,7 +20,7 @@ static const uint8_t PROGMEM menu_propmt[] = { 0x00, 0x1C, 0x3E, 0x3E, 0x3E, 0x1
 
 struct menu_ops_t
 {
-    void (*find_entry)(struct menu_info_t *menu_info, uint8_t num);
+    void (*find_entry)(struct menu_info_t *menu_info, uint16_t num);
     void (*print_next_entry)(struct menu_info_t *menu_info);
     void (*loop_begin)(struct menu_info_t *menu_info);
     void (*loop_end)(struct menu_info_t *menu_info);
@@ -28,7 +28,7 @@ struct menu_ops_t
 
 //// PGM menu functions
 
-static void menu_pgm_find_entry(struct menu_info_t *menu_info, uint8_t num);
+static void menu_pgm_find_entry(struct menu_info_t *menu_info, uint16_t num);
 static void menu_pgm_print_next_entry(struct menu_info_t *menu_info);
 static void menu_pgm_loop_begin(struct menu_info_t *menu_info);
 static void menu_pgm_loop_end(struct menu_info_t *menu_info);
@@ -52,7 +52,7 @@ void menu_pgm_init(const char* const entries[], uint8_t num_items, struct menu_i
     menu_info->ops = &menu_pgm_ops;
 }
 
-static void menu_pgm_find_entry(struct menu_info_t *menu_info, uint8_t num)
+static void menu_pgm_find_entry(struct menu_info_t *menu_info, uint16_t num)
 {
     menu_pgm_index = num;
 }
@@ -90,7 +90,7 @@ static void menu_pgm_loop_end(struct menu_info_t *menu_info)
 
 //// FAT32 menu functions
 
-static void menu_fat32_find_entry(struct menu_info_t *menu_info, uint8_t num);
+static void menu_fat32_find_entry(struct menu_info_t *menu_info, uint16_t num);
 static void menu_fat32_print_next_entry(struct menu_info_t *menu_info);
 static void menu_fat32_loop_begin(struct menu_info_t *menu_info);
 static void menu_fat32_loop_end(struct menu_info_t *menu_info);
@@ -115,10 +115,20 @@ void menu_fat32_init(const char* name_p, struct menu_info_t *menu_info)
     
     fat32_seek(0);
 
-    char numstr[2];
-    fat32_read(numstr, 2);
+    // Either "NN\n" followed by lines of text, or "NN/RR\n" followed by
+    // records of RR bytes each, as written by scripts/pack_menu
+    char header[MENU_FAT32_HEADER_LEN];
+    fat32_read(header, MENU_FAT32_HEADER_LEN);
 
-    menu_info->num_items = 10*(numstr[0] - '0') + (numstr[1] - '0');
+    menu_info->num_items = 10*(header[0] - '0') + (header[1] - '0');
+
+    if(header[2] == '/')
+    {
+        menu_info->record_len = 10*(header[3] - '0') + (header[4] - '0');
+    } else {
+        menu_info->record_len = 0;
+    }
+    menu_info->base = MENU_FAT32_HEADER_LEN;
 
     log_puts("Number of menu items: ");
     log_put_uint8(menu_info->num_items);
@@ -131,27 +141,72 @@ void menu_fat32_init(const char* name_p, struct menu_info_t *menu_info)
     menu_info->ops = &menu_fat32_ops;
 }
 
-static void menu_fat32_find_entry(struct menu_info_t *menu_info, uint8_t num)
+// Menu showing the first SSD1306_LINE_WIDTH-1 characters of num_items records
+// of a binary file, starting at base
+void menu_fat32_records_init(const char* name_p, uint32_t base, uint8_t record_len, uint16_t num_items, struct menu_info_t *menu_info)
 {
-    fat32_seek(0);
+    menu_info->data = (void *)name_p;
+    menu_info->base = base;
+    menu_info->record_len = record_len;
+    menu_info->num_items = num_items;
 
-    fat32_skip_until('\n');        
+    menu_info->top = 0;
+    menu_info->current_option = 0;
+    menu_info->ops = &menu_fat32_ops;
+}
 
-    for(uint8_t i = 0; i < menu_info->top; i++)
-    {
-        fat32_skip_until('\n');
-    }
+static void menu_fat32_find_entry(struct menu_info_t *menu_info, uint16_t num)
+{
+    menu_fat32_seek_entry(menu_info, num);
 }
 
 static void menu_fat32_print_next_entry(struct menu_info_t *menu_info)
 {
+    uint8_t len = SSD1306_LINE_WIDTH-1;
+
+    if(menu_info->record_len && menu_info->record_len < len)
+    {
+        len = menu_info->record_len;
+    }
+
     char c;
-    for(uint8_t j = 0; j < SSD1306_LINE_WIDTH-1; j++)
+    uint8_t i;
+    for(i = 0; i < len; i++)
     {
         fat32_read(&c, 1);
         ssd1306_text_putc(c);
     }
-    fat32_skip_until('\n');
+
+    while(i < SSD1306_LINE_WIDTH-1)
+    {
+        ssd1306_text_putc(' ');
+        i++;
+    }
+
+    if(menu_info->record_len)
+    {
+        fat32_read(NULL, menu_info->record_len - len);
+    } else {
+        fat32_skip_until('\n');
+    }
+}
+
+void menu_fat32_seek_entry(struct menu_info_t *menu_info, uint16_t num)
+{
+    if(menu_info->record_len)
+    {
+        fat32_seek(menu_info->base + (uint32_t)num * menu_info->record_len);
+    } else {
+        // Plain text menu, count the lines from the start
+        fat32_seek(0);
+
+        fat32_skip_until('\n');
+
+        for(uint16_t i = 0; i < num; i++)
+        {
+            fat32_skip_until('\n');
+        }
+    }
 }
 
 static void menu_fat32_loop_begin(struct menu_info_t *menu_info)
@@ -172,7 +227,7 @@ static void menu_fat32_loop_end(struct menu_info_t *menu_info)
 
 //// EEPROM menu functions
 
-static void menu_eeprom_find_entry(struct menu_info_t *menu_info, uint8_t num);
+static void menu_eeprom_find_entry(struct menu_info_t *menu_info, uint16_t num);
 static void menu_eeprom_print_next_entry(struct menu_info_t *menu_info);
 static void menu_eeprom_loop_begin(struct menu_info_t *menu_info);
 static void menu_eeprom_loop_end(struct menu_info_t *menu_info);
@@ -191,7 +246,7 @@ void menu_eeprom_init(struct menu_info_t *menu_info)
 
     uint8_t i;
 
-    for(i = 0; i < 128; i++)
+    for(i = 0; i < MENU_EEPROM_MAX_ITEMS; i++)
     {
         uint8_t c = 0xFF;
 
@@ -214,7 +269,7 @@ void menu_eeprom_init(struct menu_info_t *menu_info)
     menu_info->ops = &menu_eeprom_ops;
 }
 
-static void menu_eeprom_find_entry(struct menu_info_t *menu_info, uint8_t num)
+static void menu_eeprom_find_entry(struct menu_info_t *menu_info, uint16_t num)
 {
     menu_eeprom_ptr = (void*) (8 * num);
 }
@@ -310,7 +365,7 @@ void menu_prev(struct menu_info_t *menu_info)
 
 void menu_next(struct menu_info_t *menu_info)
 {
-    if(menu_info->current_option < menu_info->num_items - 1)
+    if(menu_info->current_option + 1 < menu_info->num_items)
     {
         menu_info->current_option++;
     }
@@ -320,7 +375,7 @@ void menu_next(struct menu_info_t *menu_info)
     }
 }
 
-uint8_t menu_loop(struct menu_info_t *menu_info)
+uint16_t menu_loop(struct menu_info_t *menu_info)
 {
     ssd1306_clear();
 
@@ -335,7 +390,7 @@ uint8_t menu_loop(struct menu_info_t *menu_info)
     menu_redraw(menu_info);
 
     uint8_t done = 0;
-    uint8_t res;
+    uint16_t res;
     
     while(!done)
     {
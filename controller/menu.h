@@ -1,23 +1,32 @@
 #ifndef MENU_H_
 #define MENU_H_
 
-#define MENU_BACK_FLAG 0x80
+#define MENU_BACK_FLAG 0x8000
 #define MENU_EXT "MNU"
+#define MENU_FAT32_HEADER_LEN 6
+
+// Playlist entries of 8 bytes from the start of the EEPROM. The last 8 bytes
+// are kept for settings.
+#define MENU_EEPROM_MAX_ITEMS 127
 
 struct menu_ops_t;
 
 struct menu_info_t
 {
-    uint8_t current_option;
-    uint8_t top;
-    uint8_t num_items;
+    uint16_t current_option;
+    uint16_t top;
+    uint16_t num_items;
+    uint8_t record_len; // Fixed record length of a FAT32 menu, 0 for lines of text
+    uint32_t base; // File offset of the first record of a FAT32 menu
     void *data;
     const struct menu_ops_t *ops;
 };
 
-uint8_t menu_loop(struct menu_info_t *menu_info);
+uint16_t menu_loop(struct menu_info_t *menu_info);
 void menu_pgm_init(const char* const entries[], uint8_t num_items, struct menu_info_t *menu_info);
 void menu_fat32_init(const char* name_p, struct menu_info_t *menu_info);
+void menu_fat32_records_init(const char* name_p, uint32_t base, uint8_t record_len, uint16_t num_items, struct menu_info_t *menu_info);
+void menu_fat32_seek_entry(struct menu_info_t *menu_info, uint16_t num);
 void menu_eeprom_init(struct menu_info_t *menu_info);
 
 #endif
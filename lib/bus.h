@@ -0,0 +1,27 @@
+#ifndef BUS_H_
+#define BUS_H_
+
+// Addresses of the register writes in the song files and on the bus from
+// the controller to the channel boards. Every board sees every write and
+// keeps the ones to its own registers, see channel/board.c.
+
+// 2A03 APU, $4000-$4017
+#define BUS_APU          0x00
+#define BUS_APU_STATUS   0x15
+#define BUS_APU_FRAME    0x17
+
+// Konami VRC6, $9000-$9003, $A000-$A002 and $B000-$B002:
+// BUS_VRC6 + 4 * (pulse 1, pulse 2, saw) + register
+#define BUS_VRC6         0x20
+#define BUS_VRC6_PULSE1  0x20
+#define BUS_VRC6_PULSE2  0x24
+#define BUS_VRC6_SAW     0x28
+
+// Sunsoft 5B: BUS_FME7 + the register selected at $C000, for each value
+// written to $E000
+#define BUS_FME7         0x30
+
+// 0xB0-0xB7 are the bank switches nsf_play records, which no board keeps,
+// and 0xF0-0xFF are the special records of the song files
+
+#endif
@@ -11,7 +11,7 @@
 
 #define FAT32_DEBUG 0
 
-#define CLUSTER_CACHE_SIZE 8
+#define MAX_EXTENTS        8
 #define BYTES_PER_SECTOR   512
 
 #define END_CLUSTER_MASK 0x0FFFFFF8
@@ -25,7 +25,19 @@ struct fat32_t {
     uint8_t  sector_in_cluster;
     uint32_t current_cluster;
 
-    uint32_t cluster_cache[CLUSTER_CACHE_SIZE];
+    // Runs of consecutive clusters making up the open file. If the file has
+    // more than MAX_EXTENTS runs the rest is found by reading the FAT.
+    struct {
+        uint32_t cluster;
+        uint16_t length;
+    } extents[MAX_EXTENTS];
+
+    uint8_t num_extents;
+    uint8_t extents_complete;
+
+    // Directory index, see fat32_find_index()
+    uint32_t index_sector;
+    uint16_t index_count;
 };
 
 struct fat32_t fat32_data;
@@ -36,11 +48,14 @@ struct fat32_file_t
     uint32_t cluster;
     uint32_t size;
 
-    uint8_t cluster_num;
+    uint8_t extent;          // Extent of the current cluster
+    uint16_t extent_cluster; // Index of the current cluster within the extent
 };
 
 struct fat32_file_t fat32_file;
 
+static void fat32_find_index(uint32_t fsinfo_sector);
+
 
 static uint32_t fat32_read_partition_table()
 {
@@ -110,7 +125,8 @@ static uint32_t fat32_read_partition_table()
 
 // http://www.easeus.com/resource/fat32-disk-structure.htm
 // https://www.pjrc.com/tech/8051/ide/fat32.html
-static void fat32_read_boot_sector(uint32_t partition_start)
+// Returns the sector of the FS information sector
+static uint32_t fat32_read_boot_sector(uint32_t partition_start)
 {
     sd_begin_sector(partition_start);
 
@@ -124,8 +140,9 @@ static void fat32_read_boot_sector(uint32_t partition_start)
     uint32_t fat_size = sd_read_uint32(); // sectors per FAT
     sd_skip_bytes(4);
     fat32_data.root_dir_cluster = sd_read_uint32();
+    uint16_t fsinfo_sector = sd_read_uint16();
 
-    sd_skip_bytes(0x1CE);
+    sd_skip_bytes(0x1CC);
 
     uint16_t boot_sector_signature __attribute__((__unused__)) = sd_read_uint16();
 
@@ -173,6 +190,8 @@ static void fat32_read_boot_sector(uint32_t partition_start)
 
     log_puts_P(PSTR("\n\n"));
 #endif
+
+    return partition_start + fsinfo_sector;
 }
 
 static uint32_t fat32_get_sector(const uint32_t cluster, uint16_t sector)
@@ -183,13 +202,18 @@ static uint32_t fat32_get_sector(const uint32_t cluster, uint16_t sector)
 
 static void fat32_open_cluster(uint32_t cluster)
 {
-    sd_begin_sector(fat32_get_sector(cluster, 0));
+    sd_stream_sector(fat32_get_sector(cluster, 0));
     fat32_data.sector_in_cluster = 0;
     fat32_data.current_cluster = cluster;
 }
 
 void fat32_open_root_dir()
 {
+    // No extents, so the clusters of the directory are read from the FAT
+    fat32_data.num_extents = 0;
+    fat32_data.extents_complete = 0;
+    fat32_file.extent = 0;
+
     fat32_open_cluster(fat32_data.root_dir_cluster);
     fat32_file.bytes_left = 0x0FFFFFFF;
 }
@@ -198,7 +222,8 @@ void fat32_open_root_dir()
 void fat32_init()
 {
     uint32_t partition_start = fat32_read_partition_table();
-    fat32_read_boot_sector(partition_start);
+    uint32_t fsinfo_sector = fat32_read_boot_sector(partition_start);
+    fat32_find_index(fsinfo_sector);
 }
 
 static uint32_t fat32_get_next_cluster_from_fat(const uint32_t cluster)
@@ -230,26 +255,45 @@ static uint32_t fat32_get_next_cluster_from_fat(const uint32_t cluster)
 
 static uint32_t fat32_next_cluster()
 {
-    if(fat32_file.cluster_num < CLUSTER_CACHE_SIZE )
+    if(fat32_file.extent < fat32_data.num_extents)
     {
-        return fat32_data.cluster_cache[fat32_file.cluster_num++];
-    } else {
-        return fat32_get_next_cluster_from_fat(fat32_data.current_cluster);
+        if(++fat32_file.extent_cluster < fat32_data.extents[fat32_file.extent].length)
+        {
+            return fat32_data.extents[fat32_file.extent].cluster + fat32_file.extent_cluster;
+        }
+
+        fat32_file.extent++;
+        fat32_file.extent_cluster = 0;
+
+        if(fat32_file.extent < fat32_data.num_extents)
+        {
+            return fat32_data.extents[fat32_file.extent].cluster;
+        }
+
+        if(fat32_data.extents_complete)
+        {
+            return END_CLUSTER_MASK;
+        }
     }
+
+    return fat32_get_next_cluster_from_fat(fat32_data.current_cluster);
 }
 
 
-// TODO: optimise by reading more than one byte at a time
 uint16_t fat32_read(void *sd_buf, uint16_t len)
 {
     uint8_t *buf = (uint8_t*) sd_buf;
     uint16_t read = 0;
-    while((read < len) && fat32_file.bytes_left)
+
+    if(len > fat32_file.bytes_left)
+    {
+        len = fat32_file.bytes_left;
+    }
+
+    while(read < len)
     {
         if(sd_sector_done())
         {
-            sd_end_sector();
-
             fat32_data.sector_in_cluster++;
             
             if(fat32_data.sector_in_cluster == fat32_data.sectors_per_cluster)
@@ -266,17 +310,15 @@ uint16_t fat32_read(void *sd_buf, uint16_t len)
                 fat32_data.current_cluster = next_cluster;
             }
 
-            sd_begin_sector(fat32_get_sector(fat32_data.current_cluster, fat32_data.sector_in_cluster));
+            // Keeps the multiple block read going unless the next cluster is elsewhere
+            sd_stream_sector(fat32_get_sector(fat32_data.current_cluster, fat32_data.sector_in_cluster));
         }
 
-        if(sd_buf)
-        {
-            buf[read] = sd_read_uint8();
-        } else {
-            sd_read_uint8();
-        }
-        fat32_file.bytes_left--;
-        read++;
+        // Read up to the end of the sector in one go
+        uint16_t n = sd_read_block(sd_buf ? buf + read : NULL, len - read);
+
+        fat32_file.bytes_left -= n;
+        read += n;
     }
     return read;
 }
@@ -300,76 +342,121 @@ uint16_t fat32_skip_until(uint8_t c)
 }
 
 
-static void fat32_create_cluster_cache(uint32_t cluster)
+// Walk the cluster chain and store it as runs of consecutive clusters. The
+// FAT entries of a contiguous file are next to each other, so a FAT sector
+// is only read once as long as the chain runs forwards.
+static void fat32_create_extents(uint32_t cluster)
 {
-    fat32_data.cluster_cache[0] = fat32_get_next_cluster_from_fat(cluster);
+    uint32_t fat_sector = 0;
+    uint16_t fat_pos = 0;
+    uint8_t sector_open = 0;
 
-#if FAT32_DEBUG
-    log_puts("Creating cluster cache:\n");
+    fat32_data.num_extents = 0;
+    fat32_data.extents_complete = 0;
 
-    log_puts(" 0x");
-    log_put_uint32_hex(cluster);
-    log_puts("\n");
+    fat32_data.extents[0].cluster = cluster;
+    fat32_data.extents[0].length = 1;
+
+#if FAT32_DEBUG
+    log_puts("Creating extents:\n");
 #endif
 
-    for(uint8_t i = 0; i < CLUSTER_CACHE_SIZE; i++)
+    for(;;)
     {
-        fat32_data.cluster_cache[i] = fat32_get_next_cluster_from_fat(cluster);
-        cluster = fat32_data.cluster_cache[i];
+        uint32_t address = cluster * 4;
+        uint32_t sector = fat32_data.fat_start + address / BYTES_PER_SECTOR;
+        uint16_t offset = address & 0x1ff;
 
-#if FAT32_DEBUG
-        log_puts(" 0x");
-        log_put_uint32_hex(cluster);
-        log_puts("\n");
-#endif
+        if(!sector_open || sector != fat_sector || offset < fat_pos)
+        {
+            if(sector_open)
+            {
+                sd_end_sector();
+            }
+            sd_begin_sector(sector);
+            sector_open = 1;
+            fat_sector = sector;
+            fat_pos = 0;
+        }
+
+        sd_skip_bytes(offset - fat_pos);
+        uint32_t next_cluster = sd_read_uint32();
+        fat_pos = offset + 4;
 
-        if((cluster & END_CLUSTER_MASK) == END_CLUSTER_MASK)
+        if((next_cluster & END_CLUSTER_MASK) == END_CLUSTER_MASK)
         {
+            fat32_data.num_extents++;
+            fat32_data.extents_complete = 1;
             break;
         }
+
+        if(next_cluster == cluster + 1)
+        {
+            fat32_data.extents[fat32_data.num_extents].length++;
+        } else {
+            if(++fat32_data.num_extents == MAX_EXTENTS)
+            {
+                // Too fragmented, the rest of the chain is read from the FAT as we go
+                break;
+            }
+
+            fat32_data.extents[fat32_data.num_extents].cluster = next_cluster;
+            fat32_data.extents[fat32_data.num_extents].length = 1;
+        }
+
+        cluster = next_cluster;
     }
 
+    sd_end_sector();
+
 #if FAT32_DEBUG
-    log_puts("Done.\n");
+    for(uint8_t i = 0; i < fat32_data.num_extents; i++)
+    {
+        log_puts(" 0x");
+        log_put_uint32_hex(fat32_data.extents[i].cluster);
+        log_puts(" +");
+        log_put_uint16(fat32_data.extents[i].length);
+        log_puts("\n");
+    }
+    log_puts(fat32_data.extents_complete ? "Done.\n" : "Incomplete.\n");
 #endif
 }
 
+// Directory entries and index entries start with the 8.3 name padded with spaces
+static void fat32_make_name(char *name, const char *filename, const char *ext)
+{
+    memset(name, ' ', 11);
+
+    for(uint8_t i = 0; i < 8 && filename[i]; i++)
+    {
+        name[i] = filename[i];
+    }
+
+    for(uint8_t i = 0; i < 3 && ext[i]; i++)
+    {
+        name[8 + i] = ext[i];
+    }
+}
+
 static uint8_t fat32_get_file_data(const char *filename, const char *ext, struct fat32_file_t *file_data)
 {
-    char dir_filename[8];
-    char dir_ext[3];
-    uint8_t attrib;
-    uint16_t cluster_hi;
-    uint16_t cluster_lo;
-    uint32_t file_size;
+    char name[11];
+    uint8_t entry[32];
     uint8_t match;
 
 #if FAT32_DEBUG
     uint16_t i = 0;
 #endif
 
-    do {
-        fat32_read(dir_filename, 8);
-        fat32_read(dir_ext, 3);
-        fat32_read(&attrib, 1);
-        fat32_read(NULL, 8);
-        fat32_read(&cluster_hi, 2);
-        fat32_read(NULL, 4);
-        fat32_read(&cluster_lo, 2);
-        fat32_read(&file_size, 4);
-
-        match = 0;
+    fat32_make_name(name, filename, ext);
 
-        for(uint8_t j = 0; j < 8; j++)
+    do {
+        if(fat32_read(entry, sizeof(entry)) != sizeof(entry))
         {
-            if(dir_filename[j] == ' ')
-                dir_filename[j] = 0;
+            entry[0] = 0;
         }
 
-        if(!strncmp(filename, dir_filename, 8) && !strncmp(ext, dir_ext, 3))
-        {
-            match = 1;
-        }
+        match = !memcmp(name, entry, 11);
 
 #if FAT32_DEBUG
         if(match)
@@ -383,7 +470,7 @@ static uint8_t fat32_get_file_data(const char *filename, const char *ext, struct
 
         i++;
 #endif
-    } while(dir_filename[0] && !match);
+    } while(entry[0] && !match);
 
     sd_end_sector();
 
@@ -392,33 +479,181 @@ static uint8_t fat32_get_file_data(const char *filename, const char *ext, struct
         return 0;
     }
 
-    file_data->size = file_size;
+    uint16_t cluster_hi;
+    uint16_t cluster_lo;
+
+    memcpy(&cluster_hi, &entry[20], 2);
+    memcpy(&cluster_lo, &entry[26], 2);
+    memcpy(&file_data->size, &entry[28], 4);
     file_data->cluster = ((uint32_t) cluster_hi << 16) | cluster_lo;
 
     return 1;
 }
 
-
-// Assumes that we are in the beginning of a directory cluster
-uint8_t fat32_open_file(const char *filename, const char *ext)
+static void fat32_open_file_data()
 {
-    if(!fat32_get_file_data(filename, ext, &fat32_file))
-    {
-        return 0;
-    }
-
 #if FAT32_DEBUG
     log_puts_P(PSTR("File cluster: 0x"));
     log_put_uint32_hex(fat32_file.cluster);
     log_putc('\n');
 #endif
 
-    fat32_create_cluster_cache(fat32_file.cluster);
+    fat32_create_extents(fat32_file.cluster);
     
     fat32_open_cluster(fat32_file.cluster);
     
     fat32_file.bytes_left = fat32_file.size;
-    fat32_file.cluster_num = 0;
+    fat32_file.extent = 0;
+    fat32_file.extent_cluster = 0;
+}
+
+// DIRINDEX.IDX, written by scripts/dir_index, holds the root directory
+// sorted by name: a 16 byte header ("DIDX", number of entries, entry size,
+// header size, and the free cluster count and next free cluster of the FS
+// information sector when it was written) and entries of the padded 8.3
+// name, attributes, first cluster and size. A name is found by a binary
+// search with one sector read per step.
+//
+// The index is only used if it is contiguous, so that an entry is found
+// from its first sector without the FAT, and if the FS information sector
+// still matches, as adding or removing files on a PC changes it.
+
+#define INDEX_HEADER_SIZE 16
+#define INDEX_ENTRY_SIZE  20
+
+static void fat32_find_index(uint32_t fsinfo_sector)
+{
+    fat32_data.index_count = 0;
+
+    fat32_open_root_dir();
+
+    if(!fat32_get_file_data("DIRINDEX", "IDX", &fat32_file))
+    {
+        return;
+    }
+
+    fat32_open_file_data();
+
+    uint8_t header[INDEX_HEADER_SIZE];
+    uint8_t valid = fat32_read(header, sizeof(header)) == sizeof(header) &&
+        !memcmp(header, "DIDX", 4) && header[6] == INDEX_ENTRY_SIZE && header[7] == INDEX_HEADER_SIZE;
+    uint8_t contiguous = fat32_data.num_extents == 1 && fat32_data.extents_complete;
+
+    fat32_close_file();
+
+    if(!valid)
+    {
+        return;
+    }
+
+    if(!contiguous)
+    {
+        log_puts_P(PSTR("Directory index is fragmented\n"));
+        return;
+    }
+
+    uint32_t fsinfo[2];
+
+    sd_begin_sector(fsinfo_sector);
+    sd_skip_bytes(488);
+    fsinfo[0] = sd_read_uint32(); // Free clusters
+    fsinfo[1] = sd_read_uint32(); // Next free cluster
+    sd_end_sector();
+
+    if(memcmp(fsinfo, &header[8], sizeof(fsinfo)))
+    {
+        log_puts_P(PSTR("Directory index is out of date\n"));
+        return;
+    }
+
+    fat32_data.index_sector = fat32_get_sector(fat32_file.cluster, 0);
+    fat32_data.index_count = header[4] | (header[5] << 8);
+
+    log_puts_P(PSTR("Directory index: "));
+    log_put_uint16(fat32_data.index_count);
+    log_puts_P(PSTR(" files\n"));
+}
+
+// Reads the entry at pos of the index, which may straddle two sectors
+static void fat32_index_read_entry(uint32_t pos, uint8_t *entry)
+{
+    uint32_t sector = fat32_data.index_sector + pos / BYTES_PER_SECTOR;
+
+    sd_stream_sector(sector);
+    sd_skip_bytes(pos % BYTES_PER_SECTOR);
+
+    uint16_t n = sd_read_block(entry, INDEX_ENTRY_SIZE);
+
+    if(n < INDEX_ENTRY_SIZE)
+    {
+        sd_stream_sector(sector + 1);
+        sd_read_block(entry + n, INDEX_ENTRY_SIZE - n);
+    }
+}
+
+static uint8_t fat32_index_lookup(const char *filename, const char *ext, struct fat32_file_t *file_data)
+{
+    char name[11];
+    uint8_t entry[INDEX_ENTRY_SIZE];
+    uint16_t lo = 0;
+    uint16_t hi = fat32_data.index_count;
+
+    if(!hi)
+    {
+        return 0;
+    }
+
+    fat32_make_name(name, filename, ext);
+
+    while(lo < hi)
+    {
+        uint16_t mid = lo + (hi - lo) / 2;
+
+        fat32_index_read_entry(INDEX_HEADER_SIZE + (uint32_t)mid * INDEX_ENTRY_SIZE, entry);
+
+        int cmp = memcmp(name, entry, 11);
+
+        if(!cmp)
+        {
+            sd_end_sector();
+
+            memcpy(&file_data->cluster, &entry[12], 4);
+            memcpy(&file_data->size, &entry[16], 4);
+            return 1;
+        }
+
+        if(cmp < 0)
+        {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    sd_end_sector();
+
+    return 0;
+}
+
+
+// Assumes that we are in the beginning of a directory cluster
+uint8_t fat32_open_file(const char *filename, const char *ext)
+{
+    // Files missing from the index might have been added after it was made
+    if(!fat32_index_lookup(filename, ext, &fat32_file))
+    {
+        if(fat32_data.index_count)
+        {
+            fat32_open_root_dir();
+        }
+
+        if(!fat32_get_file_data(filename, ext, &fat32_file))
+        {
+            return 0;
+        }
+    }
+
+    fat32_open_file_data();
     
     return 1;
 }
@@ -431,20 +666,19 @@ void fat32_close_file()
 
 
 
-void fat32_seek(uint16_t len)
+void fat32_seek(uint32_t len)
 {
-    uint16_t seek_clusters = len / fat32_data.sectors_per_cluster / BYTES_PER_SECTOR;
-//    uint16_t seek_sectors = (len - seek_clusters * fat32_data.sectors_per_cluster) / BYTES_PER_SECTOR; // This looks wrong!
-    // Should probably be:
-    uint16_t seek_sectors = (len / BYTES_PER_SECTOR) - seek_clusters * fat32_data.sectors_per_cluster;
+    uint32_t sector = len / BYTES_PER_SECTOR;
+    uint32_t seek_clusters = sector / fat32_data.sectors_per_cluster;
+    uint8_t seek_sectors = sector - seek_clusters * fat32_data.sectors_per_cluster;
     uint16_t seek_bytes = len % BYTES_PER_SECTOR;
 
 #if FAT32_DEBUG
-    log_puts(  "Seek clusters: ");
-    log_put_uint16(seek_clusters);
+    log_puts(  "Seek clusters: 0x");
+    log_put_uint32_hex(seek_clusters);
 
     log_puts("\nSeek sectors:  ");
-    log_put_uint16(seek_sectors);
+    log_put_uint8(seek_sectors);
 
     log_puts("\nSeek bytes:    ");
     log_put_uint16(seek_bytes);
@@ -454,17 +688,48 @@ void fat32_seek(uint16_t len)
 
     sd_end_sector();
 
-    fat32_data.current_cluster = fat32_file.cluster;
-    fat32_file.cluster_num = 0;
+    // Find the extent holding the cluster
+    fat32_file.extent = 0;
+    fat32_file.extent_cluster = 0;
 
-    while(seek_clusters--)
+    while(fat32_file.extent < fat32_data.num_extents)
     {
-        fat32_data.current_cluster = fat32_next_cluster();
+        uint16_t length = fat32_data.extents[fat32_file.extent].length;
+
+        if(seek_clusters < length)
+        {
+            fat32_file.extent_cluster = seek_clusters;
+            seek_clusters = 0;
+            break;
+        }
+
+        seek_clusters -= length;
+        fat32_file.extent++;
+    }
+
+    if(fat32_file.extent < fat32_data.num_extents)
+    {
+        fat32_data.current_cluster = fat32_data.extents[fat32_file.extent].cluster + fat32_file.extent_cluster;
+    } else {
+        // Past the extents, or no extents at all: walk the FAT from the last known cluster
+        if(fat32_data.num_extents)
+        {
+            uint8_t last = fat32_data.num_extents - 1;
+            fat32_data.current_cluster = fat32_data.extents[last].cluster + fat32_data.extents[last].length - 1;
+            seek_clusters++;
+        } else {
+            fat32_data.current_cluster = fat32_file.cluster;
+        }
+
+        while(seek_clusters--)
+        {
+            fat32_data.current_cluster = fat32_get_next_cluster_from_fat(fat32_data.current_cluster);
+        }
     }
 
     fat32_data.sector_in_cluster = seek_sectors;
 
-    sd_begin_sector(fat32_get_sector(fat32_data.current_cluster, fat32_data.sector_in_cluster));
+    sd_stream_sector(fat32_get_sector(fat32_data.current_cluster, fat32_data.sector_in_cluster));
     sd_skip_bytes(seek_bytes);
 
     fat32_file.bytes_left = fat32_file.size - len;
@@ -11,7 +11,7 @@ void fat32_close_file();
 uint16_t fat32_read(void *raw_buf, uint16_t len);
 uint16_t fat32_skip_until(uint8_t c);
 
-void fat32_seek(uint16_t len);
+void fat32_seek(uint32_t len);
 
 void fat32_list_dir();
 
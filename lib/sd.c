@@ -17,10 +17,15 @@
 typedef struct 
 {
     uint16_t sector_bytes_left;
+
+    uint8_t streaming;
+    uint32_t stream_sector; // Next sector of a multiple block read
 } sd_data_t;
 
 sd_data_t sd_data;
 
+static void sd_send_command(uint8_t cmd, uint32_t arg, uint8_t crc);
+
 uint8_t sd_sector_done()
 {
     return sd_data.sector_bytes_left == 0;
@@ -28,6 +33,11 @@ uint8_t sd_sector_done()
 
 void sd_begin_sector(uint32_t sector)
 {
+    if(sd_data.streaming)
+    {
+        sd_end_sector();
+    }
+
     set_low(PIN_SD_CS);
 
     sd_command( 17, sector, 0xFF);
@@ -38,22 +48,68 @@ void sd_begin_sector(uint32_t sector)
     sd_data.sector_bytes_left = 512;
 }
 
-void sd_end_sector()
+// Read sectors with READ_MULTIPLE_BLOCK, so that reading the sector after
+// the previous one only costs waiting for the next data token. Any other
+// sector stops the transmission and starts a new one.
+void sd_stream_sector(uint32_t sector)
 {
-    while(sd_data.sector_bytes_left)
+    if(sd_data.streaming && sd_data.stream_sector == sector && !sd_data.sector_bytes_left)
     {
+        // Skip CRC
+        SPI_transfer(0xFF);
         SPI_transfer(0xFF);
-        sd_data.sector_bytes_left--;
+    } else {
+        sd_end_sector();
+
+        set_low(PIN_SD_CS);
+
+        sd_command( 18, sector, 0xFF);
+
+        sd_data.streaming = 1;
     }
 
-    // Skip CRC
-    SPI_transfer(0xFF);
+    while(SPI_transfer(0xFF) != 0xFE)
+        ;
+
+    sd_data.sector_bytes_left = 512;
+    sd_data.stream_sector = sector + 1;
+}
+
+static void sd_stop_stream()
+{
+    sd_send_command( 12, 0x00000000, 0xFF);
+
+    // Skip the stuff byte following STOP_TRANSMISSION
     SPI_transfer(0xFF);
 
+    while(SPI_transfer(0xFF) & 0x80)
+        ;
+
+    // Wait while the card signals busy
+    while(SPI_transfer(0xFF) != 0xFF)
+        ;
+
+    sd_data.streaming = 0;
+    sd_data.sector_bytes_left = 0;
+}
+
+void sd_end_sector()
+{
+    if(sd_data.streaming)
+    {
+        sd_stop_stream();
+    } else {
+        sd_read_block(NULL, sd_data.sector_bytes_left);
+
+        // Skip CRC
+        SPI_transfer(0xFF);
+        SPI_transfer(0xFF);
+    }
+
     set_high(PIN_SD_CS);
 }
 
-uint8_t sd_command(uint8_t cmd, uint32_t arg, uint8_t crc)
+static void sd_send_command(uint8_t cmd, uint32_t arg, uint8_t crc)
 {
     cmd |= 0x40;
 
@@ -63,6 +119,11 @@ uint8_t sd_command(uint8_t cmd, uint32_t arg, uint8_t crc)
     SPI_transfer(arg >> 8);
     SPI_transfer(arg);
     SPI_transfer(crc);
+}
+
+uint8_t sd_command(uint8_t cmd, uint32_t arg, uint8_t crc)
+{
+    sd_send_command(cmd, arg, crc);
 
     uint8_t ret;
     uint8_t i = 0;
@@ -106,10 +167,81 @@ uint8_t sd_read_uint8()
 
 void sd_skip_bytes(uint16_t bytes)
 {
-    while(bytes--)
+    sd_read_block(NULL, bytes);
+}
+
+// Wait for the byte in flight, and start clocking in the next one before
+// returning it, so that storing it and the loop overhead overlap with the
+// transfer
+static inline uint8_t sd_read_next()
+{
+    while(!(SPSR & _BV(SPIF)))
     {
-        sd_read_uint8();
     }
+
+    uint8_t data = SPDR;
+    SPDR = 0xFF;
+
+    return data;
+}
+
+static inline uint8_t sd_read_last()
+{
+    while(!(SPSR & _BV(SPIF)))
+    {
+    }
+
+    return SPDR;
+}
+
+// Read len bytes, but not past the end of the current sector, into buf. If
+// buf is NULL the bytes are skipped. Returns the number of bytes read.
+uint16_t sd_read_block(uint8_t *buf, uint16_t len)
+{
+    if(len > sd_data.sector_bytes_left)
+    {
+        len = sd_data.sector_bytes_left;
+    }
+
+    if(!len)
+    {
+        return 0;
+    }
+
+    sd_data.sector_bytes_left -= len;
+
+    uint16_t n = len - 1;
+
+    SPDR = 0xFF;
+
+    if(buf)
+    {
+        while(n >= 4)
+        {
+            buf[0] = sd_read_next();
+            buf[1] = sd_read_next();
+            buf[2] = sd_read_next();
+            buf[3] = sd_read_next();
+            buf += 4;
+            n -= 4;
+        }
+
+        while(n--)
+        {
+            *buf++ = sd_read_next();
+        }
+
+        *buf = sd_read_last();
+    } else {
+        while(n--)
+        {
+            sd_read_next();
+        }
+
+        sd_read_last();
+    }
+
+    return len;
 }
 
 
@@ -171,6 +303,11 @@ void sd_init()
     set_high(PIN_SD_CS);
 
     sd_data.sector_bytes_left = 0;
+    sd_data.streaming = 0;
+
+    // The card is up and can now be clocked at full speed, f_osc/2
+    SPCR &= ~(_BV(SPR1) | _BV(SPR0));
+    SPSR |= _BV(SPI2X);
 }
 
 #endif
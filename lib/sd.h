@@ -4,6 +4,7 @@
 uint8_t sd_command(uint8_t cmd, uint32_t arg, uint8_t crc);
 
 void sd_begin_sector(uint32_t sector);
+void sd_stream_sector(uint32_t sector);
 void sd_end_sector();
 
 uint8_t sd_sector_done();
@@ -12,6 +13,8 @@ uint32_t sd_read_uint32();
 uint16_t sd_read_uint16();
 uint8_t sd_read_uint8();
 
+uint16_t sd_read_block(uint8_t *buf, uint16_t len);
+
 void sd_skip_bytes(uint16_t bytes);
 
 void sd_debug_print_16_bytes();
@@ -0,0 +1,57 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "fat32.h"
+#include "song.h"
+
+uint8_t song_read_chunk(uint8_t max_records, song_push_t push, song_loop_t loop)
+{
+    uint8_t data[SONG_READ_CHUNK];
+    uint16_t len = 2 * (uint16_t)max_records;
+
+    if(len > SONG_READ_CHUNK)
+    {
+        len = SONG_READ_CHUNK;
+    }
+
+    len = fat32_read(data, len) & ~0x01;
+
+    for(uint8_t i = 0; i < len; i += 2)
+    {
+        if(data[i] == 0xFE || data[i] == 0xFC)
+        {
+            // The destination follows in one record (0xFE) or two (0xFC),
+            // which might not have been read yet
+            uint8_t dest_len = (data[i] == 0xFC) ? 4 : 2;
+            uint8_t dest_bytes[4];
+            uint8_t avail = len - i - 2;
+
+            if(avail > dest_len)
+            {
+                avail = dest_len;
+            }
+
+            memcpy(dest_bytes, &data[i+2], avail);
+            fat32_read(&dest_bytes[avail], dest_len - avail);
+
+            uint32_t dest = 0;
+            for(uint8_t j = 0; j < dest_len; j++)
+            {
+                dest = (dest << 8) | dest_bytes[j];
+            }
+
+            // The rest of the chunk is past the loop
+            fat32_seek(dest);
+
+            if(loop)
+            {
+                loop(dest);
+            }
+            break;
+        } else {
+            push(data[i], data[i+1]);
+        }
+    }
+
+    return len;
+}
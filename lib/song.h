@@ -0,0 +1,20 @@
+#ifndef SONG_H_
+#define SONG_H_
+
+// Reading the BIN song files from the SD card. A song is a stream of two
+// byte records, an address and a value, see bus.h. 0xF1 ends a frame and
+// 0xFF the song. 0xFE is followed by one record holding the byte offset to
+// loop to, and 0xFC by two, most significant byte first.
+
+#define SONG_READ_CHUNK 32 // Bytes, must be even
+
+typedef void (*song_push_t)(uint8_t address, uint8_t value);
+typedef void (*song_loop_t)(uint32_t dest);
+
+// Reads a chunk of at most max_records records of the open song file and
+// passes each record to push. A loop record seeks to its destination, is
+// passed to loop, if not NULL, and ends the chunk. Returns the number of
+// bytes read, 0 at the end of the file.
+uint8_t song_read_chunk(uint8_t max_records, song_push_t push, song_loop_t loop);
+
+#endif
@@ -1,19 +1,20 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
 
 #include "gme/gme.h"
 #include "gme/Nes_Apu.h"
-#include "Wave_Writer.h"
 
 #include <string>
 #include <fstream>
+#include <chrono>
+#include <algorithm>
 
 #include "dat_file.h"
-
-#ifdef ALSA
-#include <alsa/asoundlib.h>
-#endif
+#include "output_sink.h"
+#include "bus_timing.h"
 
 Blip_Buffer buf;
 Nes_Apu apu;
@@ -22,168 +23,199 @@ void output_samples( const blip_sample_t*, size_t count );
 const int out_size = 4096;
 blip_sample_t out_buf [out_size];
 
+// Samples buffered between the renderer and the playback thread
+const size_t ring_size = 1 << 16;
+
 long total_cycles;
 int frame_cycles;
+int frame_length = 29830*2;
 
 const int apu_addr = 0x4000;
 
 static unsigned int freq = 44100;
 
 
-/// ALSA /////////////////////////////////////////////////////////////////////////////////////
+void report_error(blargg_err_t error)
+{
+    fprintf(stderr, "Error: %s\n", error);
+    exit(1);
+}
 
-#ifdef ALSA
+/// Channel stems ////////////////////////////////////////////////////////////////////////////
+
+// With stems enabled every oscillator gets a Blip_Buffer of its own instead
+// of sharing buf. The buffers are linear, so the mix is read from the sum of
+// the stem buffers, with an accumulator of its own, and comes out the same to
+// the bit as from the single buffer. Summing the rounded stems was off by up
+// to an LSB per stem.
 
-snd_pcm_t *pcm_handle;
+const char *stem_names[Nes_Apu::osc_count] = { "square1", "square2", "triangle", "noise", "dmc" };
 
-static void open_hardware(const char *device)
+bool stems;
+Blip_Buffer stem_buf [Nes_Apu::osc_count];
+blip_sample_t stem_out_buf [Nes_Apu::osc_count] [out_size];
+OutputSink *stem_sink [Nes_Apu::osc_count];
+blip_long stem_mix_accum;
+
+long samples_avail()
 {
-    int pcm_error;
+    return stems ? stem_buf[0].samples_avail() : buf.samples_avail();
+}
 
-    /* Open the PCM device in playback mode */
-    pcm_error = snd_pcm_open(&pcm_handle, device, SND_PCM_STREAM_PLAYBACK, 0);
-    if (pcm_error < 0)
+// Read up to out_size samples into out_buf and pass them on
+size_t read_output()
+{
+    if(!stems)
     {
-        printf("ERROR: Can't open \"%s\" PCM device. %s\n", device, snd_strerror(pcm_error));
-        exit(1);
+        size_t count = buf.read_samples( out_buf, out_size );
+        output_samples( out_buf, count );
+        return count;
     }
-}
 
-static void init_hardware(void)
-{
-    int pcm_error;
-    unsigned tmp;
+    size_t count = std::min(stem_buf[0].samples_avail(), (long)out_size);
+    static blip_long mix_delta [out_size];
 
-    snd_pcm_hw_params_t *params;
+    std::fill(mix_delta, mix_delta + count, 0);
 
-    /* Allocate parameters object and fill it with default values*/
+    for(int i = 0; i < Nes_Apu::osc_count; i++)
+    {
+        for(size_t n = 0; n < count; n++)
+        {
+            mix_delta[n] += stem_buf[i].buffer_[n];
+        }
 
-    snd_pcm_hw_params_alloca(&params);
+        count = stem_buf[i].read_samples( stem_out_buf[i], count );
+        stem_sink[i]->write( stem_out_buf[i], count );
+    }
 
-    snd_pcm_hw_params_any(pcm_handle, params);
+    int const bass = BLIP_READER_BASS( stem_buf[0] );
 
-    /* Set parameters */
-    pcm_error = snd_pcm_hw_params_set_access(pcm_handle, params, SND_PCM_ACCESS_RW_INTERLEAVED);
-    if (pcm_error < 0)
+    for(size_t n = 0; n < count; n++)
     {
-        printf("ERROR: Can't set interleaved mode. %s\n", snd_strerror(pcm_error));
-        exit(1);
+        blip_long s = stem_mix_accum >> (blip_sample_bits - 16);
+        out_buf[n] = std::max<blip_long>(-32768, std::min<blip_long>(32767, s));
+        stem_mix_accum += mix_delta[n] - (stem_mix_accum >> bass);
     }
 
-    pcm_error = snd_pcm_hw_params_set_format(pcm_handle, params, SND_PCM_FORMAT_S16_LE);
-    if (pcm_error < 0)
-    {
-        printf("ERROR: Can't set format. %s\n", snd_strerror(pcm_error));
-        exit(1);
-    }
+    output_samples( out_buf, count );
+    return count;
+}
 
-    pcm_error = snd_pcm_hw_params_set_channels(pcm_handle, params, 2);
-    if (pcm_error < 0)
-    {
-        printf("ERROR: Can't set channels number. %s\n", snd_strerror(pcm_error));
-        exit(1);
-    }
+void end_time_frame( int length )
+{
+    apu.end_frame( length );
 
-    pcm_error = snd_pcm_hw_params_set_rate_near(pcm_handle, params, &freq, 0);
-    if (pcm_error < 0)
+    if(stems)
     {
-        printf("ERROR: Can't set rate. %s\n", snd_strerror(pcm_error));
-        exit(1);
+        for(int i = 0; i < Nes_Apu::osc_count; i++)
+        {
+            stem_buf[i].end_frame( length );
+        }
+    } else {
+        buf.end_frame( length );
     }
 
-    pcm_error = snd_pcm_hw_params_set_buffer_size(pcm_handle, params, out_size * 4);
-    if (pcm_error < 0)
+    // Read some samples out of Blip_Buffer if there are enough to
+    // fill our output buffer
+    if ( samples_avail() >= out_size )
     {
-        printf("ERROR: Can't set buffer size. %s\n", snd_strerror(pcm_error));
-        exit(1);
+        read_output();
     }
+}
 
+void begin_frame()
+{
+    frame_cycles = frame_length;
+}
 
-    /* Write parameters */
-    pcm_error = snd_pcm_hw_params(pcm_handle, params);
-    if (pcm_error < 0)
-    {
-        printf("ERROR: Can't set harware parameters. %s\n", snd_strerror(pcm_error));
-        exit(1);
-    }
+MultiSink sinks;
 
-    /* Resume information */
-    printf("PCM name: '%s'\n", snd_pcm_name(pcm_handle));
-    printf("PCM state: %s\n", snd_pcm_state_name(snd_pcm_state(pcm_handle)));
 
-    snd_pcm_uframes_t f;
-    snd_pcm_hw_params_get_buffer_size(params, &f);
-    printf("PCM buffer size: %lu\n", f);
+/// Controller bus timing ////////////////////////////////////////////////////////////////////
 
-    snd_pcm_hw_params_get_channels(params, &tmp);
-    printf("Channels: %i ", tmp);
+// See bus_timing.h. The crystal of the controller runs at 8 times the APU
+// clock to within a few ppm, so 4 of its cycles make one of our cycles (see
+// begin_frame()).
+//
+// Timer 2 is started by the 60 Hz frame clock and sends the frame back to
+// back: the address, then the value, which is when the channels see the
+// write. The bus is idle again after the value of the last write.
 
-    if (tmp == 1)
-        printf("(mono)\n");
-    else if (tmp == 2)
-        printf("(stereo)\n");
+const int bus_cpu_cycles = 4;
+const int bus_frame_cycles = frame_clock_div * frame_clock_cycles / bus_cpu_cycles;
 
-    snd_pcm_hw_params_get_rate(params, &tmp, 0);
-    printf("Rate: %d bps\n", tmp);
-}
+// The strobe of the controller, see -t
+int bus_strobe = bus_strobe_default;
 
-/* close what we've opened */
-static void close_hardware(void)
+// Cycles from the start of the frame until the value of write n is on the bus
+long bus_write_cycles(unsigned n)
 {
-    snd_pcm_drop(pcm_handle);
-    snd_pcm_close(pcm_handle);
+    return bus_value_cycle(n, bus_strobe) / bus_cpu_cycles;
 }
 
-void output_samples_alsa( const blip_sample_t* buf, size_t count )
+// Cycles from the start of the frame until the bus is idle again
+long frame_busy_cycles(const Frame& frame)
 {
-    int pcm_error = snd_pcm_writei(pcm_handle, buf, count/2);
-    if (pcm_error == -EPIPE) {
-        printf("XRUN.\n");
-        snd_pcm_prepare(pcm_handle);
-    } else if (pcm_error < 0) {
-        printf("ERROR. Can't write to PCM device. %s\n", snd_strerror(pcm_error));
-    }
+    return bus_busy_cycles(frame.regs.size(), bus_strobe) / bus_cpu_cycles;
 }
 
-#endif
-
-
-//////////////////////////////////////////////////////////////////////////////////////////////
-
-void report_error(blargg_err_t error)
+double cycles_to_us(long cycles)
 {
-    fprintf(stderr, "Error: %s\n", error);
-    exit(1);
+    return cycles * 1e6 / (1789773.0 * 2);
 }
 
-void end_time_frame( int length )
+// Per frame bus occupancy, and the frames that don't finish before the next
+// frame clock. Since timer 2 is already running when the frame clock fires,
+// the following frame is then held back a whole frame.
+void report_bus_timing(const DatFile& dat_file, FILE *report)
 {
-    apu.end_frame( length );
-    buf.end_frame( length );
+    unsigned overruns = 0;
+    long max_busy = 0;
+    unsigned max_frame = 0;
+    double sum_busy = 0;
 
-    // Read some samples out of Blip_Buffer if there are enough to
-    // fill our output buffer
-    if ( buf.samples_avail() >= out_size )
+    if(report)
     {
-        size_t count = buf.read_samples( out_buf, out_size );
-        output_samples( out_buf, count );
+        fprintf(report, "# frame writes busy_us occupancy_percent\n");
     }
-}
 
-void begin_frame()
-{
-    frame_cycles = 29830*2;
-}
+    for(unsigned n = 0; n < dat_file.frames.size(); n++)
+    {
+        long busy = frame_busy_cycles(dat_file.frames[n]);
+
+        if(report)
+        {
+            fprintf(report, "%u %lu %.1f %.1f\n", n, (unsigned long)dat_file.frames[n].regs.size(),
+                    cycles_to_us(busy), 100.0 * busy / bus_frame_cycles);
+        }
+
+        if(busy > max_busy)
+        {
+            max_busy = busy;
+            max_frame = n;
+        }
+        sum_busy += busy;
 
-Wave_Writer *wave = 0;
+        if(busy >= bus_frame_cycles)
+        {
+            printf("Frame %u: %lu writes keep the bus busy for %.0f us, overruns the 60 Hz frame by %.0f us\n",
+                   n, (unsigned long)dat_file.frames[n].regs.size(), cycles_to_us(busy),
+                   cycles_to_us(busy - bus_frame_cycles));
+            overruns++;
+        }
+    }
+
+    if(!dat_file.frames.empty())
+    {
+        printf("Bus occupancy: average %.1f%%, max %.1f%% (%.0f us) in frame %u, %u frames overrun\n",
+               100.0 * sum_busy / dat_file.frames.size() / bus_frame_cycles,
+               100.0 * max_busy / bus_frame_cycles, cycles_to_us(max_busy), max_frame, overruns);
+    }
+}
 
 void output_samples( const blip_sample_t* buf, size_t count )
 {
-    wave->write( buf, count );
-
-#ifdef ALSA
-    output_samples_alsa(buf,count);
-#endif
+    sinks.write( buf, count );
 }
 
 int dmc_read( void*, nes_addr_t addr )
@@ -191,89 +223,301 @@ int dmc_read( void*, nes_addr_t addr )
     return 0;
 }
 
+void print_usage(char *p)
+{
+    fprintf(stderr, "Usage: %s [-w wav_file] [-r raw_file] [-n] [-a device] [-m] [-s nsecs] [-l loops] [-b file] [-t strobe] [-c prefix] bin_file [wav_file]\n"
+            "  -w file    write a WAV file\n"
+            "  -r file    write raw 16-bit little endian stereo PCM\n"
+            "  -n         discard the output (for benchmarking)\n"
+#ifdef ALSA
+            "  -a device  play on an ALSA device, e.g. \"default\"\n"
+            "  -m         use mmap access for ALSA devices given after it\n"
+#endif
+            "  -s nsecs   stop after nsecs seconds, 0 for no limit (default 30)\n"
+            "  -l loops   number of times to repeat the looping part (default: until stopped by -s)\n"
+            "  -b file    time the writes like the controller bus does, and write the bus\n"
+            "             occupancy of each frame to file (\"-\" for stdout)\n"
+            "  -t strobe  the bus strobe of the controller for -b, in delay loops (default %d)\n"
+            "  -c prefix  also write each APU channel to prefix-<channel>.wav\n"
+            "Without -w, -r, -n or -a the output is written to out.wav"
+#ifdef ALSA
+            " and played on the default ALSA device"
+#endif
+            ".\n",
+            p, bus_strobe_default);
+}
+
 int main(int argc, char *argv[])
 {
-    if(argc < 2)
+    long timeout = 30;
+    long loops = -1;
+
+#ifdef ALSA
+    bool use_mmap = false;
+#endif
+    bool bus_timing = false;
+    FILE *bus_report = 0;
+    std::string stem_prefix;
+
+    const char *opts = "w:r:na:ms:l:b:t:c:";
+    int opts_done = 0;
+
+    while(!opts_done)
     {
-        fprintf(stderr, "Usage: %s bin_file [wav_file]\n", argv[0]);
+        switch(getopt(argc, argv, opts))
+        {
+        case EOF:
+            opts_done = 1;
+            break;
+
+        case 'w':
+            sinks.add(new WaveSink(freq, optarg));
+            break;
+
+        case 'r':
+            sinks.add(new RawSink(optarg));
+            break;
+
+        case 'n':
+            sinks.add(new NullSink());
+            break;
+
+#ifdef ALSA
+        case 'a':
+            sinks.add(new ThreadedSink(new AlsaSink(optarg, freq, out_size * 4, use_mmap), ring_size));
+            break;
+
+        case 'm':
+            use_mmap = true;
+            break;
+#endif
+
+        case 's':
+            timeout = strtol(optarg, 0, 10);
+            break;
+
+        case 'l':
+            loops = strtol(optarg, 0, 10);
+            break;
+
+        case 'b':
+            bus_timing = true;
+            if(!strcmp(optarg, "-"))
+            {
+                bus_report = stdout;
+            } else {
+                bus_report = fopen(optarg, "w");
+                if(!bus_report)
+                {
+                    fprintf(stderr, "Error: Could not open file %s\n", optarg);
+                    exit(1);
+                }
+            }
+            break;
+
+        case 't':
+            bus_strobe = strtol(optarg, 0, 10);
+            if(bus_strobe < 1)
+            {
+                fprintf(stderr, "Error: The strobe must be at least 1\n");
+                exit(1);
+            }
+            break;
+
+        case 'c':
+            stems = true;
+            stem_prefix = optarg;
+            break;
+
+        default:
+            print_usage(argv[0]);
+            exit(1);
+            break;
+        }
+    }
+
+    if(argc <= optind)
+    {
+        print_usage(argv[0]);
         exit(1);
     }
 
-    std::string filename_in(argv[1]);
-    std::string filename_out("out.wav");
+    std::string filename_in(argv[optind]);
+
+    if(argc > optind + 1)
+    {
+        sinks.add(new WaveSink(freq, argv[optind + 1]));
+    }
 
-    if(argc > 2)
+    if(sinks.empty())
     {
-        filename_out = argv[2];
+#ifdef ALSA
+        sinks.add(new ThreadedSink(new AlsaSink("default", freq, out_size * 4, use_mmap), ring_size));
+#endif
+        sinks.add(new WaveSink(freq, "out.wav"));
     }
 
-    wave = new Wave_Writer(freq, filename_out.c_str());
-    wave->enable_stereo();
+    if(!timeout && loops < 0)
+    {
+        loops = 0;
+    }
 
     blargg_err_t error = buf.sample_rate( freq );
     if ( error )
         report_error( error );
     buf.clock_rate( 1789773 );
     apu.output( &buf );
+
+    if(stems)
+    {
+        for(int i = 0; i < Nes_Apu::osc_count; i++)
+        {
+            error = stem_buf[i].sample_rate( freq );
+            if ( error )
+                report_error( error );
+            stem_buf[i].clock_rate( 1789773 );
+            apu.osc_output( i, &stem_buf[i] );
+
+            stem_sink[i] = new WaveSink(freq, stem_prefix + "-" + stem_names[i] + ".wav");
+        }
+    }
     apu.dmc_reader( dmc_read );
     apu.reset(false);
     apu.dmc_reader( dmc_read );
 
-#ifdef ALSA
-    open_hardware("default");
-    init_hardware();
-#endif
-
     DatFile dat_file;
 
     dat_file.load_binary(filename_in);
 
-    int start_frame = 0;
+    unsigned start_frame = 0;
     bool loop = false;
 
-    if(dat_file.frames.back().regs[0].address == LOOP_BYTE)
+    if(!dat_file.frames.empty() && is_loop_byte_frame(dat_file.frames.back()))
     {
         loop = true;
-        int start_byte = (dat_file.frames.back().regs[1].address << 8) | dat_file.frames.back().regs[1].value;
+        uint32_t start_byte = loop_byte_dest(dat_file.frames.back());
 
-        int bytes_read = 0;
+        uint32_t bytes_read = 0;
 
-        while(bytes_read < start_byte)
+        while(bytes_read < start_byte && start_frame < dat_file.frames.size() - 1)
         {
-            bytes_read += dat_file.frames[start_frame++].regs.size() * 2;
+            bytes_read += binary_size(dat_file.frames[start_frame++]);
+        }
+
+        if(bytes_read != start_byte)
+        {
+            fprintf(stderr, "Warning: Loop destination 0x%x is not at the start of a frame\n", start_byte);
         }
 
         dat_file.frames.pop_back();
     }
 
-    do {
-        for(Frame frame : dat_file.frames)
+    if(bus_timing)
+    {
+        report_bus_timing(dat_file, bus_report);
+
+        if(bus_report != stdout)
         {
-            for(Reg reg : frame.regs)
+            fclose(bus_report);
+        }
+
+        frame_length = bus_frame_cycles;
+    }
+
+    // The frames are twice as long as a NES frame, see begin_frame()
+    const long max_cycles = 1789773L * 2 * timeout;
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    begin_frame();
+
+    unsigned first_frame = 0;
+    bool done = false;
+
+    while(!done)
+    {
+        for(unsigned n = first_frame; n < dat_file.frames.size(); n++)
+        {
+            if(bus_timing)
             {
-                total_cycles += 0;
-                apu.write_register(0, total_cycles, reg.address + apu_addr, reg.value);
-                frame_cycles -= 0;
+                const std::vector<Reg>& regs = dat_file.frames[n].regs;
+                long start = 0;
+                long t = 0;
+
+                for(unsigned i = 0; i < regs.size(); i++)
+                {
+                    const Reg& reg = regs[i];
+                    t = bus_write_cycles(i) - start;
+
+                    // An overrunning frame spills over into the next frame clock
+                    while(t >= frame_cycles)
+                    {
+                        t -= frame_cycles;
+                        start += frame_cycles;
+                        end_time_frame( frame_cycles );
+                        total_cycles += frame_cycles;
+                        begin_frame();
+                    }
+
+                    apu.write_register(t, total_cycles + t, reg.address + apu_addr, reg.value);
+                }
+
+                // If the bus is still busy at the next frame clock the next frame waits for another one
+                if(frame_busy_cycles(dat_file.frames[n]) - start >= frame_cycles)
+                {
+                    end_time_frame( frame_cycles );
+                    total_cycles += frame_cycles;
+                    begin_frame();
+                }
+            } else {
+                for(Reg reg : dat_file.frames[n].regs)
+                {
+                    apu.write_register(0, total_cycles, reg.address + apu_addr, reg.value);
+                }
             }
 
             end_time_frame( frame_cycles );
             total_cycles += frame_cycles;
             begin_frame();
 
-            if(total_cycles > 1789773L * 2 * 30)
+            if(timeout && total_cycles > max_cycles)
             {
-                loop = false;
+                done = true;
                 break;
             }
         }
-    } while(loop);
 
-    delete wave;
+        if(!loop || !loops--)
+        {
+            done = true;
+        }
+
+        first_frame = start_frame;
+    }
 
-#ifdef ALSA
-    snd_pcm_drain(pcm_handle);
-    close_hardware();
-#endif
+    // Flush what is left in the Blip_Buffer
+    while(read_output())
+    {
+    }
+
+    if(stems)
+    {
+        for(int i = 0; i < Nes_Apu::osc_count; i++)
+        {
+            delete stem_sink[i];
+        }
+    }
+
+    sinks.finish();
+
+    double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    double audio_time = total_cycles / (1789773.0 * 2);
+
+    printf("Rendered %.1f s of audio in %.3f s (%.1f s of audio per second%s)\n",
+           audio_time, wall_time, wall_time > 0 ? audio_time / wall_time : 0.0,
+           sinks.realtime() ? ", paced by playback" : "");
+
+    sinks.print_stats();
 
     return 0;
 }
@@ -0,0 +1,46 @@
+#ifndef BUS_TIMING_H_
+#define BUS_TIMING_H_
+
+// The timing of the frame clock and of the bus from the controller to the
+// channel boards, see timers_init(), bus_write() and TIMER2_COMPA_vect in
+// controller/main.c. Times are in cycles of the crystal, which the
+// controller and the channels share.
+
+#include <stdint.h>
+
+// Timer 0 of the controller fires the 240 Hz frame clock every
+// 256 * (OCR0A + 1) cycles
+const int frame_clock_cycles = 256 * (232 + 1);
+
+// The controller sends a frame of writes every fourth frame clock
+const int frame_clock_div = 4;
+
+// bus_strobe when the EEPROM holds no calibrated value, BUS_STROBE_DEFAULT
+const int bus_strobe_default = 40;
+
+// Timer 2 fires (OCR2A + 1) * 8 cycles after the frame clock
+const int bus_start_cycles = (15 + 1) * 8;
+
+// Each phase of bus_write(), the address with DCLK high and the value with
+// DCLK low, is bus_strobe delay loops of 3 cycles, and a few cycles to set
+// the pins and pop the next write
+inline int bus_phase_cycles(int strobe)
+{
+    return 3 * strobe + 8;
+}
+
+// The cycle after the frame clock at which the value of write n of a frame
+// is on the bus, at the falling edge of DCLK
+inline long bus_value_cycle(unsigned n, int strobe)
+{
+    return bus_start_cycles + (2 * n + 1) * (long)bus_phase_cycles(strobe);
+}
+
+// The cycle after the frame clock at which timer 2 is done with a frame of
+// writes, and bus_busy is cleared
+inline long bus_busy_cycles(unsigned writes, int strobe)
+{
+    return bus_start_cycles + 2 * writes * (long)bus_phase_cycles(strobe);
+}
+
+#endif
@@ -0,0 +1,327 @@
+// Renders BIN files with the firmware of the channel boards instead of an
+// emulation of the APU, to hear what the boards actually play: the periods
+// the timers can reach, the four bit DACs, the interrupts that write the
+// previous sample, and the writes arriving while the bus is sent.
+//
+// Every board runs channel/nes_apu_channel.c built for the host, see
+// channel_sim.h. The boards add the changes of their DACs to one table per
+// tick of the frame clock, which is mixed down to the output in one pass,
+// so a song renders in a small fraction of its length and a whole library
+// can be rendered for listening tests.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "dat_file.h"
+#include "channel_sim.h"
+#include "Wave_Writer.h"
+
+static const long sample_rate = 44100;
+
+/// Bus timing /////////////////////////////////////////////////////////////////////////////////
+
+// The tick at which the channels see the value of write n of a frame, at the
+// default strobe of the controller, see bus_timing.h
+static int bus_write_tick(unsigned n)
+{
+    const int tick = bus_value_cycle(n, bus_strobe_default) / 8;
+
+    // A frame too long for the buffer of the controller is squeezed in
+    return tick < FRAME_CLOCK_TICKS ? tick : FRAME_CLOCK_TICKS - 1;
+}
+
+/// Rendering //////////////////////////////////////////////////////////////////////////////////
+
+struct Song
+{
+    DatFile dat_file;
+    unsigned start_frame;
+    bool loop;
+};
+
+static void load_song(const std::string& filename, Song& song)
+{
+    song.dat_file.load_binary(filename);
+    song.start_frame = 0;
+    song.loop = false;
+
+    std::vector<Frame>& frames = song.dat_file.frames;
+
+    if(!frames.empty() && is_loop_byte_frame(frames.back()))
+    {
+        song.loop = true;
+        uint32_t start_byte = loop_byte_dest(frames.back());
+
+        uint32_t bytes_read = 0;
+
+        while(bytes_read < start_byte && song.start_frame < frames.size() - 1)
+        {
+            bytes_read += binary_size(frames[song.start_frame++]);
+        }
+
+        if(bytes_read != start_byte)
+        {
+            fprintf(stderr, "Warning: Loop destination 0x%x is not at the start of a frame\n", start_byte);
+        }
+
+        frames.pop_back();
+    }
+}
+
+class Renderer
+{
+public:
+    Renderer(const std::vector<unsigned>& board_ids) : mixer(sample_rate), delta(FRAME_CLOCK_TICKS)
+    {
+        for(unsigned id : board_ids)
+        {
+            boards.push_back(ChannelBoard(id));
+        }
+    }
+
+    // One tick of the frame clock, with the writes of frame if it is not null
+    void frame_clock(const Frame *frame, std::vector<short>& out)
+    {
+        std::fill(delta.begin(), delta.end(), 0);
+
+        for(ChannelBoard& board : boards)
+        {
+            board.frame_update();
+        }
+
+        int t = 0;
+
+        if(frame)
+        {
+            for(unsigned n = 0; n < frame->regs.size(); n++)
+            {
+                const Reg& reg = frame->regs[n];
+                const int write_tick = bus_write_tick(n);
+
+                run(t, write_tick);
+                t = write_tick;
+
+                for(ChannelBoard& board : boards)
+                {
+                    if(board.keeps(reg.address))
+                    {
+                        board.write_reg(reg.address, reg.value);
+                    }
+                }
+            }
+        }
+
+        run(t, FRAME_CLOCK_TICKS);
+
+        mixer.mix(delta.data(), FRAME_CLOCK_TICKS, out);
+    }
+
+private:
+    void run(int from, int to)
+    {
+        for(ChannelBoard& board : boards)
+        {
+            board.run(&delta[from], to - from);
+        }
+    }
+
+    std::vector<ChannelBoard> boards;
+    DacMixer mixer;
+    std::vector<int32_t> delta;
+};
+
+// Renders the song and returns the number of samples
+static long render(const Song& song, const std::vector<unsigned>& board_ids, long timeout, long loops, Wave_Writer *wave)
+{
+    Renderer renderer(board_ids);
+    std::vector<short> out;
+
+    const std::vector<Frame>& frames = song.dat_file.frames;
+    const long max_frame_clocks = 240L * timeout;
+
+    long frame_clocks = 0;
+    long samples = 0;
+    unsigned first_frame = 0;
+    bool done = false;
+
+    while(!done)
+    {
+        for(unsigned n = first_frame; n < frames.size() && !done; n++)
+        {
+            for(int i = 0; i < FRAME_CLOCK_DIV; i++)
+            {
+                renderer.frame_clock(i ? 0 : &frames[n], out);
+            }
+
+            frame_clocks += FRAME_CLOCK_DIV;
+
+            if(timeout && frame_clocks >= max_frame_clocks)
+            {
+                done = true;
+            }
+
+            if(out.size() >= sample_rate || done)
+            {
+                if(wave)
+                {
+                    wave->write(out.data(), out.size());
+                }
+                samples += out.size();
+                out.clear();
+            }
+        }
+
+        if(!song.loop || !loops--)
+        {
+            done = true;
+        }
+
+        first_frame = song.start_frame;
+    }
+
+    if(wave)
+    {
+        wave->write(out.data(), out.size());
+    }
+
+    return samples + out.size();
+}
+
+/// Main ///////////////////////////////////////////////////////////////////////////////////////
+
+static std::string wave_filename(const std::string& dir, const std::string& filename_in)
+{
+    std::string name = filename_in.substr(filename_in.find_last_of('/') + 1);
+    size_t dot = name.find_last_of('.');
+
+    if(dot != std::string::npos)
+    {
+        name = name.substr(0, dot);
+    }
+
+    return dir + "/" + name + ".wav";
+}
+
+void print_usage(char *p)
+{
+    fprintf(stderr, "Usage: %s [-d dir] [-n] [-s nsecs] [-l loops] [-b boards] bin_file...\n"
+            "Render each bin_file with the firmware of the channel boards to dir/<name>.wav.\n"
+            "  -d dir     directory of the WAV files (default: the current directory)\n"
+            "  -n         discard the output (for benchmarking)\n"
+            "  -s nsecs   stop after nsecs seconds, 0 for no limit (default 0)\n"
+            "  -l loops   number of times to repeat the looping part (default: until stopped\n"
+            "             by -s, or none without it)\n"
+            "  -b boards  the IDs of the boards on the bus, see channel/board.h\n"
+            "             (default 0123, the four APU channels)\n",
+            p);
+}
+
+int main(int argc, char *argv[])
+{
+    std::string dir = ".";
+    bool discard = false;
+    long timeout = 0;
+    long loops = -1;
+    std::vector<unsigned> board_ids = { BOARD_SQ1, BOARD_SQ2, BOARD_TRI, BOARD_NOISE };
+
+    const char *opts = "d:ns:l:b:";
+    int opts_done = 0;
+
+    while(!opts_done)
+    {
+        switch(getopt(argc, argv, opts))
+        {
+        case EOF:
+            opts_done = 1;
+            break;
+
+        case 'd':
+            dir = optarg;
+            break;
+
+        case 'n':
+            discard = true;
+            break;
+
+        case 's':
+            timeout = strtol(optarg, 0, 10);
+            break;
+
+        case 'l':
+            loops = strtol(optarg, 0, 10);
+            break;
+
+        case 'b':
+            board_ids.clear();
+            for(const char *p = optarg; *p; p++)
+            {
+                if(*p < '0' || *p >= '0' + NUM_BOARDS)
+                {
+                    fprintf(stderr, "Error: Unknown board ID '%c'\n", *p);
+                    exit(1);
+                }
+                board_ids.push_back(*p - '0');
+            }
+            break;
+
+        default:
+            print_usage(argv[0]);
+            exit(1);
+            break;
+        }
+    }
+
+    if(argc <= optind)
+    {
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    if(!timeout && loops < 0)
+    {
+        loops = 0;
+    }
+
+    long total_samples = 0;
+    auto start_time = std::chrono::steady_clock::now();
+
+    for(int i = optind; i < argc; i++)
+    {
+        std::string filename_in(argv[i]);
+        Song song;
+
+        try
+        {
+            load_song(filename_in, song);
+        } catch(DatFileException& e) {
+            fprintf(stderr, "Error: %s: %s\n", filename_in.c_str(), e.message.c_str());
+            continue;
+        }
+
+        Wave_Writer *wave = discard ? 0 : new Wave_Writer(sample_rate, wave_filename(dir, filename_in).c_str());
+
+        long samples = render(song, board_ids, timeout, loops, wave);
+
+        delete wave;
+
+        printf("%s: %.1f s\n", filename_in.c_str(), (double)samples / sample_rate);
+
+        total_samples += samples;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    double seconds = (double)total_samples / sample_rate;
+
+    printf("Rendered %.1f s in %.2f s, %.0fx real time\n", seconds, elapsed.count(),
+           elapsed.count() > 0 ? seconds / elapsed.count() : 0.0);
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+#include <math.h>
+
+#include <algorithm>
+
+#include "channel_sim.h"
+
+extern "C" {
+#include "../channel/config.h"
+#include "../lib/bus.h"
+}
+
+/// Timer 1 ////////////////////////////////////////////////////////////////////////////////////
+// The timer hooks of nes_apu_channel.c. The timer counts from 0 up to TOP,
+// OCR1A or ICR1, where the sample interrupt fires, and is cleared at the next
+// tick. A TOP lowered below the count makes it run on to 0xFFFF and wrap, as
+// on the AVR. Stopping the clock keeps the count.
+
+extern "C" void channel_timer_start(void)
+{
+    current_channel->muted = 0;
+}
+
+extern "C" void channel_timer_stop(void)
+{
+    current_channel->muted = 1;
+}
+
+extern "C" void channel_timer_set_period(uint16_t period)
+{
+    current_channel->reload_period = period;
+}
+
+/// Boards /////////////////////////////////////////////////////////////////////////////////////
+
+struct BoardType
+{
+    uint8_t first_address;
+    uint8_t last_address;
+    bool apu;
+
+    void (*write_reg)(uint8_t address, uint8_t val);
+    void (*frame_update)(void);
+};
+
+// As boards[] in channel/board.c
+static const BoardType board_types[NUM_BOARDS] = {
+    { BUS_APU + 0x00,  BUS_APU + 0x03,         true,  write_reg_sq1,        frame_update_sq },
+    { BUS_APU + 0x04,  BUS_APU + 0x07,         true,  write_reg_sq2,        frame_update_sq },
+    { BUS_APU + 0x08,  BUS_APU + 0x0B,         true,  write_reg_tri,        frame_update_tri },
+    { BUS_APU + 0x0C,  BUS_APU + 0x0F,         true,  write_reg_noise,      frame_update_noise },
+    { BUS_VRC6_PULSE1, BUS_VRC6_PULSE1 + 0x02, false, write_reg_vrc6_pulse, frame_update_vrc6_pulse },
+    { BUS_VRC6_PULSE2, BUS_VRC6_PULSE2 + 0x02, false, write_reg_vrc6_pulse, frame_update_vrc6_pulse },
+};
+
+// Worst case cycles of the sample interrupts, including the entry, as
+// counted by isr_cycles: the noise interrupt takes longer when it loads the
+// next byte of noise_table.c, every seventh sample
+static const int square_isr_cycles = 31;
+static const int triangle_isr_cycles = 30;
+static const int noise_isr_cycles = 29;
+static const int noise_load_isr_cycles = 47;
+
+ChannelBoard::ChannelBoard(unsigned id) : board_id(id), state(), tcnt(0), dac(0), next_output(0),
+                                          now(0), last_sample_tick(0), last_sample_cycles(0), noise_bit(0)
+{
+    // The jumpers, or the bits read_conf() sets from the board ID
+    state.conf = (id & 1 ? _BV(CONF0_BIT) : 0) | (id & 2 ? _BV(CONF1_BIT) : 0);
+    state.shift_register = 1;
+    state.muted = 1;
+}
+
+void ChannelBoard::select()
+{
+    current_channel = &state;
+}
+
+bool ChannelBoard::keeps(uint8_t address) const
+{
+    const BoardType& type = board_types[board_id];
+
+    return (address >= type.first_address && address <= type.last_address) ||
+        (type.apu && (address == BUS_APU_STATUS || address == BUS_APU_FRAME));
+}
+
+void ChannelBoard::write_reg(uint8_t address, uint8_t value)
+{
+    select();
+    board_types[board_id].write_reg(address, value);
+}
+
+void ChannelBoard::frame_update()
+{
+    select();
+    board_types[board_id].frame_update();
+}
+
+// The sample interrupts of channel/main.c, after the DAC has been written
+uint8_t ChannelBoard::sample()
+{
+    switch(board_id)
+    {
+    case BOARD_TRI:
+    {
+        last_sample_cycles = triangle_isr_cycles;
+        state.step = (state.step + 1) & 0x1F;
+
+        uint8_t val = state.step;
+
+        if(state.step & 0x10)
+        {
+            val = ~state.step;
+        }
+
+        return val & 0x0F;
+    }
+
+    case BOARD_NOISE:
+    {
+        last_sample_cycles = noise_bit ? noise_isr_cycles : noise_load_isr_cycles;
+        noise_bit = (noise_bit + 1) % 7;
+
+        // The bits of noise_table.c, clocked here instead of read back
+        const int tap = (state.shift_mode & _BV(SHIFT_MODE_BIT)) ? 6 : 1;
+        const uint16_t feedback = (state.shift_register ^ (state.shift_register >> tap)) & 0x01;
+
+        state.shift_register = (state.shift_register >> 1) | (feedback << 14);
+
+        return (state.shift_register & 0x01) ? 0 : state.volume;
+    }
+
+    default:
+        last_sample_cycles = square_isr_cycles;
+        state.step = (state.step + 1) & 0x0F;
+
+        return (state.step < state.duty_cycle) ? state.volume : 0;
+    }
+}
+
+void ChannelBoard::run(int32_t *delta, int ticks)
+{
+    const uint64_t start = now;
+
+    now += ticks;
+
+    if(state.muted)
+    {
+        return;
+    }
+
+    int t = 0;
+
+    for(;;)
+    {
+        const uint16_t top = state.reload_period;
+        const int to_match = (tcnt <= top) ? top - tcnt : 0x10000 - tcnt + top;
+
+        if(t + to_match >= ticks)
+        {
+            tcnt += ticks - t;
+            return;
+        }
+
+        t += to_match;
+
+        // The interrupt writes the sample computed the time before, and
+        // computes the next one
+        delta[t] += next_output - dac;
+        dac = next_output;
+        next_output = sample();
+        last_sample_tick = start + t;
+
+        tcnt = 0;
+        t++;
+    }
+}
+
+long ChannelBoard::sample_isr_left(uint64_t cycle) const
+{
+    const uint64_t end = 8 * last_sample_tick + last_sample_cycles;
+
+    return end > cycle ? end - cycle : 0;
+}
+
+double ChannelBoard::sample_isr_load() const
+{
+    if(state.muted)
+    {
+        return 0;
+    }
+
+    const int cycles = board_id == BOARD_TRI ? triangle_isr_cycles :
+        board_id == BOARD_NOISE ? noise_isr_cycles : square_isr_cycles;
+
+    return std::min(1.0, (double)cycles / (8 * (state.reload_period + 1)));
+}
+
+/// Mixer //////////////////////////////////////////////////////////////////////////////////////
+
+// Full scale of a single DAC in the output samples
+static const int DAC_SCALE = 500;
+
+// Corner frequency of the output capacitor
+static const double DC_CORNER = 16.0;
+
+DacMixer::DacMixer(long rate) : sample_rate(rate), tick(0), next_sample_tick(0), num_samples(0),
+                                level(0), sum(0), sum_ticks(0), prev_in(0), prev_out(0)
+{
+    dc_factor = exp(-2 * M_PI * DC_CORNER / sample_rate);
+    end_sample();
+}
+
+// Sample n ends at tick n * TIMER_RATE / sample_rate, rounded up, in
+// integers as TIMER_RATE is a half
+void DacMixer::end_sample()
+{
+    num_samples++;
+    next_sample_tick = (num_samples * 3579545 + 2 * sample_rate - 1) / (2 * sample_rate);
+
+    sum = 0;
+    sum_ticks = 0;
+}
+
+void DacMixer::mix(const int32_t *delta, int ticks, std::vector<short>& out)
+{
+    int i = 0;
+
+    while(i < ticks)
+    {
+        // The ticks up to the end of the sample, or of the table
+        const int end = std::min<uint64_t>(ticks, i + (next_sample_tick - tick));
+
+        tick += end - i;
+        sum_ticks += end - i;
+
+        for(; i < end; i++)
+        {
+            level += delta[i];
+            sum += level;
+        }
+
+        if(tick < next_sample_tick)
+        {
+            break;
+        }
+
+        const double in = (double)sum / sum_ticks * DAC_SCALE / 15;
+        const double y = in - prev_in + dc_factor * prev_out;
+
+        prev_in = in;
+        prev_out = y;
+
+        long s = lrint(y);
+        if(s > 32767) s = 32767;
+        if(s < -32768) s = -32768;
+        out.push_back(s);
+
+        end_sample();
+    }
+}
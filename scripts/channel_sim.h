@@ -0,0 +1,122 @@
+#ifndef CHANNEL_SIM_H_
+#define CHANNEL_SIM_H_
+
+// The channel boards simulated on the host: the register handlers and frame
+// updates of channel/nes_apu_channel.c, built for the host, driven by a
+// model of timer 1 and of the sample interrupts in channel/main.c.
+//
+// Time is counted in ticks of timer 1, F_CPU / 8, which is also the APU
+// clock and the clock of timer 2 of the controller.
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "bus_timing.h"
+
+extern "C" {
+#include "../channel/nes_apu_channel.h"
+}
+
+// The firmware reaches the state of the current board through this macro,
+// which would otherwise take over every use of the name
+#undef channel
+
+// Timer ticks per second
+const double TIMER_RATE = 14318180.0 / 8;
+
+// Timer ticks per tick of the 240 Hz frame clock
+const int FRAME_CLOCK_TICKS = frame_clock_cycles / 8;
+
+// The controller sends a frame of writes every fourth frame clock
+const int FRAME_CLOCK_DIV = frame_clock_div;
+
+// Board IDs, as in channel/board.h
+enum
+{
+    BOARD_SQ1,
+    BOARD_SQ2,
+    BOARD_TRI,
+    BOARD_NOISE,
+    BOARD_VRC6_PULSE1,
+    BOARD_VRC6_PULSE2,
+    NUM_BOARDS
+};
+
+class ChannelBoard
+{
+public:
+    ChannelBoard(unsigned id);
+
+    // Whether the board keeps the writes to address, see bus_filter
+    bool keeps(uint8_t address) const;
+
+    // A write the board has kept
+    void write_reg(uint8_t address, uint8_t value);
+
+    // An edge of the frame clock
+    void frame_update();
+
+    // Runs timer 1 for ticks ticks and adds the change of the DAC at every
+    // sample interrupt to delta[tick]
+    void run(int32_t *delta, int ticks);
+
+    unsigned id() const { return board_id; }
+
+    // The level on the DAC, 0-15
+    uint8_t output() const { return dac; }
+
+    // Cycles the last sample interrupt still runs for at cycle, counted
+    // like the ticks since the board was created
+    long sample_isr_left(uint64_t cycle) const;
+
+    // The share of the cycles taken by the sample interrupt
+    double sample_isr_load() const;
+
+private:
+    void select();
+    uint8_t sample();
+
+    unsigned board_id;
+    channel_t state;
+
+    uint16_t tcnt;       // TCNT1
+    uint8_t dac;         // PINS_DAC_PORT
+    uint8_t next_output; // channel_output, written at the next interrupt
+
+    uint64_t now;        // Ticks run
+    uint64_t last_sample_tick;
+    uint8_t last_sample_cycles;
+    uint8_t noise_bit;   // Bit of the byte in noise_table.c
+};
+
+// Sums the DACs of the boards, as the resistors of the mixer do, box
+// filters the sum down to the sample rate and blocks the DC like the
+// output capacitor
+class DacMixer
+{
+public:
+    DacMixer(long sample_rate);
+
+    // Mixes ticks ticks, given as the changes of the summed DAC level at
+    // each tick, and appends the finished samples to out
+    void mix(const int32_t *delta, int ticks, std::vector<short>& out);
+
+private:
+    void end_sample();
+
+    long sample_rate;
+    uint64_t tick;
+    uint64_t next_sample_tick;
+    uint64_t num_samples;
+
+    int32_t level;
+    int64_t sum;
+    uint32_t sum_ticks;
+
+    double dc_factor;
+    double prev_in;
+    double prev_out;
+};
+
+#endif
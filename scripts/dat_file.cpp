@@ -26,6 +26,74 @@ bool operator!=(const Frame& frame1, const Frame& frame2)
     return frame1.regs != frame2.regs;    
 }
 
+bool is_loop_byte_frame(const Frame& frame)
+{
+    if(frame.regs.empty())
+    {
+        return false;
+    }
+
+    if(frame.regs[0].address == LOOP_BYTE)
+    {
+        return frame.regs.size() >= 2;
+    }
+
+    if(frame.regs[0].address == LOOP_BYTE_LONG)
+    {
+        return frame.regs.size() >= 3;
+    }
+
+    return false;
+}
+
+uint32_t loop_byte_dest(const Frame& frame)
+{
+    uint32_t dest = 0;
+    unsigned n = (frame.regs[0].address == LOOP_BYTE_LONG) ? 2 : 1;
+
+    for(unsigned i = 1; i <= n; i++)
+    {
+        dest = (dest << 16) | (frame.regs[i].address << 8) | frame.regs[i].value;
+    }
+
+    return dest;
+}
+
+Frame loop_byte_frame(uint32_t dest)
+{
+    Frame frame;
+
+    // Stick to the short form where it fits, older controller firmware only knows that one
+    if(dest <= 0xFFFF)
+    {
+        frame.regs.push_back(Reg(LOOP_BYTE, LOOP_BYTE));
+    } else {
+        frame.regs.push_back(Reg(LOOP_BYTE_LONG, LOOP_BYTE_LONG));
+        frame.regs.push_back(Reg((dest >> 24) & 0xFF, (dest >> 16) & 0xFF));
+    }
+    frame.regs.push_back(Reg((dest >> 8) & 0xFF, dest & 0xFF));
+
+    return frame;
+}
+
+uint32_t binary_size(const Frame& frame)
+{
+    return (frame.regs.size() + 1) * 2;
+}
+
+// The number of register pairs after a loop record that hold its
+// destination. They are read as they are, even where an address byte of the
+// offset is END_FRAME or END_SONG.
+static unsigned loop_dest_pairs(int address)
+{
+    if(address == LOOP_BYTE_LONG)
+    {
+        return 2;
+    }
+
+    return (address == LOOP_BYTE) ? 1 : 0;
+}
+
 void DatFile::clear()
 {
     frames.clear();
@@ -44,7 +112,7 @@ void expect(std::string::iterator& it, char c)
 
 static void expect(std::string::iterator& it, std::string s)
 {
-    for(c : s)
+    for(char c : s)
     {
         if(*it != c)
         {
@@ -77,6 +145,7 @@ void DatFile::load_ascii(std::istream& in)
     std::string line;
 
     Frame frame;
+    unsigned dest_pairs = 0;
 
     while(std::getline(in, line))
     {
@@ -90,7 +159,10 @@ void DatFile::load_ascii(std::istream& in)
         int value = read_hex2(it);
         expect(it, ",");
 
-        if(address == END_FRAME) {
+        if(dest_pairs) {
+            frame.regs.push_back(Reg(address, value));
+            dest_pairs--;
+        } else if(address == END_FRAME) {
             frames.push_back(frame);
             frame.regs.clear();
         } else if(address == END_SONG) {
@@ -101,6 +173,7 @@ void DatFile::load_ascii(std::istream& in)
             }
         } else {
             frame.regs.push_back(Reg(address, value));
+            dest_pairs = loop_dest_pairs(address);
         }
     }
 
@@ -112,10 +185,14 @@ void DatFile::load_binary(std::istream& in)
     int address, value;
 
     Frame frame;
-    
+    unsigned dest_pairs = 0;
+
     while((address = in.get()) >= 0 && (value = in.get()) >= 0)
     {
-        if(address == END_FRAME) {
+        if(dest_pairs) {
+            frame.regs.push_back(Reg(address, value));
+            dest_pairs--;
+        } else if(address == END_FRAME) {
             frames.push_back(frame);
             frame.regs.clear();
         } else if(address == END_SONG) {
@@ -126,6 +203,7 @@ void DatFile::load_binary(std::istream& in)
             }
         } else {
             frame.regs.push_back(Reg(address, value));
+            dest_pairs = loop_dest_pairs(address);
         }
     }
 
@@ -1,6 +1,8 @@
 #ifndef DAT_FILE_H_
 #define DAT_FILE_H_
 
+#include <stdint.h>
+
 #include <vector>
 #include <string>
 #include <istream>
@@ -11,7 +13,8 @@ enum
     END_FRAME = 0xf1,
     END_SONG = 0xff,
     LOOP_FRAME = 0xfd,
-    LOOP_BYTE = 0xfe
+    LOOP_BYTE = 0xfe,
+    LOOP_BYTE_LONG = 0xfc
 };
 
 struct Reg
@@ -33,6 +36,16 @@ bool operator!=(const Reg& reg1, const Reg& reg2);
 bool operator==(const Frame& frame1, const Frame& frame2);
 bool operator!=(const Frame& frame1, const Frame& frame2);
 
+// The loop record of a BIN file holds the byte offset of the frame to jump
+// to. LOOP_BYTE is followed by a 16-bit offset in one register pair, and
+// LOOP_BYTE_LONG by a 32-bit offset in two pairs, most significant first.
+bool is_loop_byte_frame(const Frame& frame);
+uint32_t loop_byte_dest(const Frame& frame);
+Frame loop_byte_frame(uint32_t dest);
+
+// Size of the frame in a BIN file, including its end of frame marker
+uint32_t binary_size(const Frame& frame);
+
 class DatFileException
 {
 public:
@@ -29,23 +29,17 @@ int main(int argc, char *argv[])
         int loop_frame_dest = (last_frame.regs[1].address << 8) | last_frame.regs[1].value;
         std::cout << "Loop to frame " << loop_frame_dest << "\n";
 
-        int loop_byte_dest = 0;
+        uint32_t loop_byte_dest = 0;
 
         for(int i = 0; i < loop_frame_dest; i++)
         {
-            loop_byte_dest += dat_file.frames[i].regs.size() * 2;
+            loop_byte_dest += binary_size(dat_file.frames[i]);
         }
 
         std::cout << "Loop to byte " << loop_byte_dest << "\n";
 
         dat_file.frames.pop_back();
-
-        Frame loop_frame;
-
-        loop_frame.regs.push_back(Reg(LOOP_BYTE, LOOP_BYTE));
-        loop_frame.regs.push_back(Reg((loop_byte_dest >> 8)  & 0xFF , loop_byte_dest & 0xFF));
-
-        dat_file.frames.push_back(loop_frame);
+        dat_file.frames.push_back(loop_byte_frame(loop_byte_dest));
     }
 
     dat_file.save_binary(filename_out);
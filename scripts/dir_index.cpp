@@ -0,0 +1,65 @@
+// Writes a sorted index of the root directory of an SD card image into
+// DIRINDEX.IDX, so that the controller can find files with a binary search
+// instead of scanning the directory. See Fat32Image::write_dir_index() for
+// the format.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <vector>
+
+#include "fat32_image.h"
+
+void print_usage(char *p)
+{
+    fprintf(stderr, "Usage: %s image\n"
+            "Write the index of the root directory of image, a whole SD card image or\n"
+            "block device, to DIRINDEX.IDX. Create the file first, %d bytes per file\n"
+            "plus %d is enough.\n",
+            p, Fat32Image::INDEX_ENTRY_SIZE, Fat32Image::INDEX_HEADER_SIZE);
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc != 2)
+    {
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    Fat32Image image(argv[1], true);
+
+    size_t num_files = image.write_dir_index();
+
+    // The controller reads 32 bytes per directory entry until it finds a
+    // match, while the index takes one sector read per probe, two for an
+    // entry across a sector boundary
+    std::vector<Fat32Image::Entry> dir = image.root_dir();
+
+    unsigned long scan_sectors = 0;
+    unsigned long scan_worst = 0;
+
+    for(size_t i = 0; i < dir.size(); i++)
+    {
+        unsigned long sectors = (i + 1) * 32 / Fat32Image::BYTES_PER_SECTOR + 1;
+
+        if(dir[i].is_file() && memcmp(dir[i].name, "DIRINDEXIDX", 11))
+        {
+            scan_sectors += sectors;
+            scan_worst = sectors;
+        }
+    }
+
+    printf("Indexed %lu files\n", (unsigned long)num_files);
+
+    if(num_files)
+    {
+        printf("Directory scan: %.1f sectors on average, %lu at worst\n",
+               (double)scan_sectors / num_files, scan_worst);
+        printf("Index lookup:   %d sectors at worst\n", (int)ceil(log2(num_files + 1)) + 1);
+    }
+
+    return 0;
+}
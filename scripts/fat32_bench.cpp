@@ -0,0 +1,359 @@
+// Runs the controller's FAT32 driver, lib/fat32.c, on an SD card image and
+// replays what the controller does with the card: opening songs, streaming
+// them into the register buffer frame by frame and following their loops,
+// and redrawing the menus. Reports the SPI traffic, see sd_image.c for how
+// it is counted.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "fat32_image.h"
+#include "sd_image.h"
+
+extern "C" {
+#include "sd.h"
+#include "fat32.h"
+#include "song.h"
+
+extern int log_host_enabled;
+}
+
+// As in controller/main.c and controller/menu.c
+const int song_buf_len = 128;
+const int frames_per_second = 60;
+const int menu_height = 8;
+const int menu_line_width = 20;
+const int menu_header_len = 6;
+
+// A saturated SPI bus at f_osc/2 takes 16 cycles per byte
+const double f_cpu = 14318180;
+const double cycles_per_byte = 16;
+
+void print_usage(char *p)
+{
+    fprintf(stderr, "Usage: %s [options] image [song ...]\n"
+            "Replay the SD card accesses of the controller on image. The songs are\n"
+            "base names of BIN files, by default all of them are played.\n"
+            "Options:\n"
+            "  -s seconds  Seconds of music to play of each song (default: 60)\n"
+            "  -a bytes    Bytes before the data token of a block (default: %u)\n"
+            "  -r bytes    Bytes before the response to a command (default: %u)\n"
+            "  -v          Show the log output of the FAT32 driver\n",
+            p, sd_image_access_bytes, sd_image_response_bytes);
+}
+
+static unsigned long spi_bytes_since(unsigned long start)
+{
+    return sd_image_stats.spi_bytes - start;
+}
+
+static bool open_file(const std::string& name, const char *ext)
+{
+    fat32_open_root_dir();
+    return fat32_open_file(name.c_str(), ext);
+}
+
+// The song playing loop of the controller: top up the register buffer in
+// chunks the way song_read_data() does, then let the timer interrupt
+// output one frame
+struct SongResult
+{
+    unsigned long open_bytes;
+    unsigned long play_bytes;
+    unsigned long commands;
+    unsigned long frames;
+    unsigned long loops;
+};
+
+// The addresses read by play_song(), and its result, for song_read_chunk()
+static std::vector<uint8_t> song_buf;
+static SongResult *song_result;
+
+static void song_read_push(uint8_t address, uint8_t value)
+{
+    song_buf.push_back(address);
+}
+
+static void song_read_loop(uint32_t dest)
+{
+    song_result->loops++;
+}
+
+static bool play_song(const std::string& name, unsigned long max_frames, SongResult& result)
+{
+    memset(&result, 0, sizeof(result));
+
+    unsigned long start = sd_image_stats.spi_bytes;
+
+    if(!open_file(name, "BIN"))
+    {
+        return false;
+    }
+
+    result.open_bytes = spi_bytes_since(start);
+
+    start = sd_image_stats.spi_bytes;
+    unsigned long start_commands = sd_image_stats.commands;
+
+    song_buf.clear();
+    song_result = &result;
+
+    size_t head = 0;
+    bool song_end = false;
+
+    while(!song_end && result.frames < max_frames)
+    {
+        while(song_buf.size() - head < (size_t)song_buf_len)
+        {
+            if(!song_read_chunk(song_buf_len - (song_buf.size() - head), song_read_push, song_read_loop))
+            {
+                break;
+            }
+        }
+
+        if(head == song_buf.size())
+        {
+            break;
+        }
+
+        while(head < song_buf.size())
+        {
+            uint8_t address = song_buf[head++];
+
+            if(address == 0xF1)
+            {
+                break;
+            }
+            if(address == 0xFF)
+            {
+                song_end = true;
+                break;
+            }
+        }
+
+        result.frames++;
+    }
+
+    fat32_close_file();
+
+    result.play_bytes = spi_bytes_since(start);
+    result.commands = sd_image_stats.commands - start_commands;
+
+    return true;
+}
+
+// A redraw of the menu in menu_fat32_find_entry() and
+// menu_fat32_print_next_entry(), with the menu file already open
+static void redraw_menu(uint32_t base, uint8_t record_len, uint16_t top)
+{
+    if(record_len)
+    {
+        fat32_seek(base + (uint32_t)top * record_len);
+    } else {
+        fat32_seek(0);
+        fat32_skip_until('\n');
+        for(uint16_t i = 0; i < top; i++)
+        {
+            fat32_skip_until('\n');
+        }
+    }
+
+    for(int i = 0; i < menu_height; i++)
+    {
+        char line[menu_line_width];
+        fat32_read(line, menu_line_width);
+
+        if(record_len)
+        {
+            fat32_read(NULL, record_len - menu_line_width);
+        } else {
+            fat32_skip_until('\n');
+        }
+    }
+}
+
+static void bench_menu(const char *label, const char *name, uint32_t base, uint8_t record_len, uint16_t num_items)
+{
+    unsigned long start = sd_image_stats.spi_bytes;
+    open_file(name, "MNU");
+    unsigned long open_bytes = spi_bytes_since(start);
+
+    uint16_t last = num_items > menu_height ? num_items - menu_height : 0;
+    uint16_t tops[3] = { 0, (uint16_t)(last / 2), last };
+    unsigned long bytes[3];
+
+    for(int i = 0; i < 3; i++)
+    {
+        start = sd_image_stats.spi_bytes;
+        redraw_menu(base, record_len, tops[i]);
+        bytes[i] = spi_bytes_since(start);
+    }
+
+    fat32_close_file();
+
+    printf("%-22s %6u %8lu %8lu %8lu %8lu\n", label, num_items, open_bytes, bytes[0], bytes[1], bytes[2]);
+}
+
+static void bench_menus()
+{
+    printf("%-22s %6s %8s %8s %8s %8s\n", "Menu", "Items", "Open", "First", "Middle", "Last");
+
+    uint8_t header[32];
+
+    if(open_file("CAT", "MNU"))
+    {
+        uint16_t len = fat32_read(header, menu_header_len);
+        fat32_close_file();
+
+        if(len == menu_header_len)
+        {
+            uint16_t num_items = 10 * (header[0] - '0') + (header[1] - '0');
+            uint8_t record_len = header[2] == '/' ? 10 * (header[3] - '0') + (header[4] - '0') : 0;
+
+            bench_menu(record_len ? "CAT.MNU" : "CAT.MNU (text)", "CAT", menu_header_len, record_len, num_items);
+        }
+    }
+
+    if(open_file("LIBRARY", "MNU"))
+    {
+        uint16_t len = fat32_read(header, sizeof(header));
+        fat32_close_file();
+
+        if(len == sizeof(header) && !memcmp(header, "NLIB", 4))
+        {
+            uint8_t record_len = read_le16(&header[4]);
+
+            bench_menu("LIBRARY.MNU letters", "LIBRARY", read_le32(&header[16]), record_len, read_le16(&header[6]));
+            bench_menu("LIBRARY.MNU all games", "LIBRARY", read_le32(&header[20]), record_len, read_le16(&header[8]));
+        }
+    }
+
+    printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+    double seconds = 60;
+
+    int c;
+    while((c = getopt(argc, argv, "s:a:r:v")) != -1)
+    {
+        switch(c)
+        {
+        case 's':
+            seconds = atof(optarg);
+            break;
+
+        case 'a':
+            sd_image_access_bytes = atoi(optarg);
+            break;
+
+        case 'r':
+            sd_image_response_bytes = atoi(optarg);
+            break;
+
+        case 'v':
+            log_host_enabled = 1;
+            break;
+
+        default:
+            print_usage(argv[0]);
+            exit(1);
+        }
+    }
+
+    if(optind >= argc)
+    {
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    const char *image_name = argv[optind];
+    std::vector<std::string> songs(argv + optind + 1, argv + argc);
+
+    if(songs.empty())
+    {
+        Fat32Image image(image_name);
+
+        for(const Fat32Image::Entry& entry : image.root_dir())
+        {
+            if(entry.is_file() && !memcmp(&entry.name[8], "BIN", 3))
+            {
+                songs.push_back(entry.filename().substr(0, entry.filename().find('.')));
+            }
+        }
+    }
+
+    if(!sd_image_open(image_name))
+    {
+        fprintf(stderr, "Error: Could not open file %s\n", image_name);
+        exit(1);
+    }
+
+    sd_image_reset_stats();
+
+    sd_init();
+    fat32_init();
+
+    printf("Init: %lu SPI bytes, %lu commands\n\n", sd_image_stats.spi_bytes, sd_image_stats.commands);
+
+    bench_menus();
+
+    printf("%-12s %8s %8s %6s %12s %10s %8s\n", "Song", "Open", "Seconds", "Loops", "SPI bytes/s", "Commands/s", "CPU");
+
+    unsigned long max_frames = seconds * frames_per_second;
+    double total_bytes = 0;
+    double total_seconds = 0;
+    double worst = 0;
+    unsigned long total_open = 0;
+    unsigned long played = 0;
+
+    for(const std::string& song : songs)
+    {
+        SongResult result;
+
+        if(!play_song(song, max_frames, result))
+        {
+            fprintf(stderr, "Warning: Could not open %s.BIN\n", song.c_str());
+            continue;
+        }
+
+        if(!result.frames)
+        {
+            continue;
+        }
+
+        double t = (double)result.frames / frames_per_second;
+        double rate = result.play_bytes / t;
+
+        printf("%-12s %8lu %8.1f %6lu %12.0f %10.1f %7.2f%%\n",
+               song.c_str(), result.open_bytes, t, result.loops, rate, result.commands / t,
+               100 * rate * cycles_per_byte / f_cpu);
+
+        total_bytes += result.play_bytes;
+        total_seconds += t;
+        total_open += result.open_bytes;
+        played++;
+
+        if(rate > worst)
+        {
+            worst = rate;
+        }
+    }
+
+    sd_image_close();
+
+    if(played)
+    {
+        printf("\n%lu songs, %.0f SPI bytes per second of music on average, %.0f at worst\n",
+               played, total_bytes / total_seconds, worst);
+        printf("%.0f SPI bytes per song open on average\n", (double)total_open / played);
+    }
+
+    return 0;
+}
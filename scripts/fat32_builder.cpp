@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fat32_builder.h"
+#include "fat32_image.h"
+
+#define PARTITION_START   2048 // 1 MB, aligned to the erase blocks of the card
+#define RESERVED_SECTORS  32
+#define NUMBER_OF_FATS    2
+#define MIN_CLUSTERS      65525 // Anything smaller is FAT16 to everyone else
+#define END_OF_CHAIN      0x0FFFFFFF
+
+static const char volume_label[] = "NESSYNTH   ";
+
+Fat32Builder::Fat32Builder(uint32_t sectors_per_cluster) : sectors_per_cluster(sectors_per_cluster)
+{
+}
+
+void Fat32Builder::add_file(const std::string& name, const std::string& ext, const std::vector<uint8_t>& data)
+{
+    if(name.empty() || name.size() > 8 || ext.size() > 3)
+    {
+        fprintf(stderr, "Error: %s.%s is not an 8.3 file name\n", name.c_str(), ext.c_str());
+        exit(1);
+    }
+
+    File file;
+
+    memset(file.name, ' ', 11);
+    for(size_t i = 0; i < name.size(); i++)
+    {
+        file.name[i] = toupper((unsigned char)name[i]);
+    }
+    for(size_t i = 0; i < ext.size(); i++)
+    {
+        file.name[8 + i] = toupper((unsigned char)ext[i]);
+    }
+
+    for(const File& f : files)
+    {
+        if(!memcmp(f.name, file.name, 11))
+        {
+            fprintf(stderr, "Error: %s.%s was added twice\n", name.c_str(), ext.c_str());
+            exit(1);
+        }
+    }
+
+    file.data = data;
+    files.push_back(file);
+}
+
+uint32_t Fat32Builder::clusters_for(size_t bytes) const
+{
+    uint32_t cluster_bytes = sectors_per_cluster * Fat32Image::BYTES_PER_SECTOR;
+    return (bytes + cluster_bytes - 1) / cluster_bytes;
+}
+
+static void write_sector(FILE *f, uint32_t sector, const uint8_t *buf, size_t len = Fat32Image::BYTES_PER_SECTOR)
+{
+    if(fseek(f, (long)sector * Fat32Image::BYTES_PER_SECTOR, SEEK_SET) || fwrite(buf, len, 1, f) != 1)
+    {
+        fprintf(stderr, "Error: Could not write sector %u\n", sector);
+        exit(1);
+    }
+}
+
+void Fat32Builder::write(const std::string& filename, uint32_t size_mb)
+{
+    // Volume label, the files and room for the end of directory marker
+    uint32_t dir_clusters = clusters_for((files.size() + 2) * 32);
+    uint32_t used_clusters = dir_clusters;
+
+    for(const File& file : files)
+    {
+        used_clusters += clusters_for(file.data.size());
+    }
+
+    uint32_t total_clusters;
+    uint32_t fat_size;
+
+    if(size_mb)
+    {
+        uint32_t partition_sectors = size_mb * 2048 - PARTITION_START;
+
+        // The FAT takes room from the clusters it describes
+        total_clusters = (partition_sectors - RESERVED_SECTORS) / sectors_per_cluster;
+        do {
+            fat_size = ((total_clusters + 2) * 4 + Fat32Image::BYTES_PER_SECTOR - 1) / Fat32Image::BYTES_PER_SECTOR;
+            total_clusters = (partition_sectors - RESERVED_SECTORS - NUMBER_OF_FATS * fat_size) / sectors_per_cluster;
+        } while(((total_clusters + 2) * 4 + Fat32Image::BYTES_PER_SECTOR - 1) / Fat32Image::BYTES_PER_SECTOR > fat_size);
+
+        if(total_clusters < used_clusters || total_clusters < MIN_CLUSTERS)
+        {
+            fprintf(stderr, "Error: %u MB is too small for the files or for FAT32 with %u sectors per cluster\n",
+                    size_mb, sectors_per_cluster);
+            exit(1);
+        }
+    } else {
+        total_clusters = used_clusters < MIN_CLUSTERS ? MIN_CLUSTERS : used_clusters;
+        fat_size = ((total_clusters + 2) * 4 + Fat32Image::BYTES_PER_SECTOR - 1) / Fat32Image::BYTES_PER_SECTOR;
+    }
+
+    uint32_t fat_start = PARTITION_START + RESERVED_SECTORS;
+    uint32_t data_start = fat_start + NUMBER_OF_FATS * fat_size;
+    uint32_t partition_sectors = RESERVED_SECTORS + NUMBER_OF_FATS * fat_size + total_clusters * sectors_per_cluster;
+    uint32_t total_sectors = PARTITION_START + partition_sectors;
+
+    FILE *f = fopen(filename.c_str(), "wb");
+    if(!f)
+    {
+        fprintf(stderr, "Error: Could not open file %s\n", filename.c_str());
+        exit(1);
+    }
+
+    uint8_t sector[Fat32Image::BYTES_PER_SECTOR];
+
+    // MBR with a single FAT32 (CHS) partition, type 0x0B as expected by the controller
+    memset(sector, 0, sizeof(sector));
+    uint8_t *p = &sector[0x1BE];
+    p[1] = 0xFE; p[2] = 0xFF; p[3] = 0xFF;
+    p[4] = 0x0B;
+    p[5] = 0xFE; p[6] = 0xFF; p[7] = 0xFF;
+    write_le32(&p[8], PARTITION_START);
+    write_le32(&p[12], partition_sectors);
+    write_le16(&sector[0x1FE], 0xAA55);
+    write_sector(f, 0, sector);
+
+    // Boot sector
+    memset(sector, 0, sizeof(sector));
+    sector[0] = 0xEB; sector[1] = 0x58; sector[2] = 0x90;
+    memcpy(&sector[3], "NESSYNTH", 8);
+    write_le16(&sector[11], Fat32Image::BYTES_PER_SECTOR);
+    sector[13] = sectors_per_cluster;
+    write_le16(&sector[14], RESERVED_SECTORS);
+    sector[16] = NUMBER_OF_FATS;
+    sector[21] = 0xF8;
+    write_le16(&sector[24], 63);
+    write_le16(&sector[26], 255);
+    write_le32(&sector[28], PARTITION_START);
+    write_le32(&sector[32], partition_sectors);
+    write_le32(&sector[36], fat_size);
+    write_le32(&sector[44], 2); // Root directory cluster
+    write_le16(&sector[48], 1); // FS info sector
+    write_le16(&sector[50], 6); // Backup boot sector
+    sector[64] = 0x80;
+    sector[66] = 0x29;
+    write_le32(&sector[67], (uint32_t)time(0));
+    memcpy(&sector[71], volume_label, 11);
+    memcpy(&sector[82], "FAT32   ", 8);
+    write_le16(&sector[0x1FE], 0xAA55);
+    write_sector(f, PARTITION_START, sector);
+    write_sector(f, PARTITION_START + 6, sector);
+
+    // FS info sector
+    memset(sector, 0, sizeof(sector));
+    write_le32(&sector[0], 0x41615252);
+    write_le32(&sector[484], 0x61417272);
+    write_le32(&sector[488], total_clusters - used_clusters);
+    write_le32(&sector[492], 2 + used_clusters);
+    write_le32(&sector[508], 0xAA550000);
+    write_sector(f, PARTITION_START + 1, sector);
+    write_sector(f, PARTITION_START + 7, sector);
+
+    // Lay out the root directory and the files one after the other
+    std::vector<uint8_t> fat((2 + used_clusters) * 4, 0);
+    write_le32(&fat[0], 0x0FFFFFF8);
+    write_le32(&fat[4], END_OF_CHAIN);
+
+    uint32_t next_cluster = 2;
+
+    auto allocate = [&](uint32_t n) -> uint32_t {
+        if(!n)
+        {
+            return 0;
+        }
+
+        uint32_t first = next_cluster;
+        for(uint32_t i = 0; i < n; i++, next_cluster++)
+        {
+            write_le32(&fat[next_cluster * 4], i + 1 < n ? next_cluster + 1 : END_OF_CHAIN);
+        }
+        return first;
+    };
+
+    auto cluster_sector = [&](uint32_t cluster) {
+        return data_start + (cluster - 2) * sectors_per_cluster;
+    };
+
+    uint32_t dir_cluster = allocate(dir_clusters);
+    std::vector<uint8_t> dir(dir_clusters * sectors_per_cluster * Fat32Image::BYTES_PER_SECTOR, 0);
+
+    time_t now = time(0);
+    struct tm *tm = localtime(&now);
+    uint16_t fat_time = (tm->tm_hour << 11) | (tm->tm_min << 5) | (tm->tm_sec / 2);
+    uint16_t fat_date = ((tm->tm_year - 80) << 9) | ((tm->tm_mon + 1) << 5) | tm->tm_mday;
+
+    memcpy(&dir[0], volume_label, 11);
+    dir[11] = Fat32Image::ATTRIB_VOLUME_ID;
+
+    for(size_t i = 0; i < files.size(); i++)
+    {
+        const File& file = files[i];
+        uint32_t cluster = allocate(clusters_for(file.data.size()));
+
+        uint8_t *e = &dir[(i + 1) * 32];
+        memcpy(e, file.name, 11);
+        e[11] = 0x20; // Archive
+        write_le16(&e[14], fat_time);
+        write_le16(&e[16], fat_date);
+        write_le16(&e[18], fat_date);
+        write_le16(&e[20], cluster >> 16);
+        write_le16(&e[22], fat_time);
+        write_le16(&e[24], fat_date);
+        write_le16(&e[26], cluster & 0xFFFF);
+        write_le32(&e[28], file.data.size());
+
+        for(size_t pos = 0; pos < file.data.size(); pos += Fat32Image::BYTES_PER_SECTOR)
+        {
+            size_t n = file.data.size() - pos;
+            if(n > Fat32Image::BYTES_PER_SECTOR)
+            {
+                n = Fat32Image::BYTES_PER_SECTOR;
+            }
+            write_sector(f, cluster_sector(cluster) + pos / Fat32Image::BYTES_PER_SECTOR, &file.data[pos], n);
+        }
+    }
+
+    write_sector(f, cluster_sector(dir_cluster), &dir[0], dir.size());
+
+    for(int i = 0; i < NUMBER_OF_FATS; i++)
+    {
+        write_sector(f, fat_start + i * fat_size, &fat[0], fat.size());
+    }
+
+    // Extend the image to its full size without writing the free space
+    fflush(f);
+    if(ftruncate(fileno(f), (off_t)total_sectors * Fat32Image::BYTES_PER_SECTOR))
+    {
+        fprintf(stderr, "Error: Could not resize %s\n", filename.c_str());
+        exit(1);
+    }
+
+    fclose(f);
+}
@@ -0,0 +1,39 @@
+#ifndef FAT32_BUILDER_H_
+#define FAT32_BUILDER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// Writes a complete SD card image: an MBR with one FAT32 partition holding
+// the files in the root directory. Every file is stored in one run of
+// consecutive clusters, in the order the files were added, so the controller
+// can map it with a single extent and stream it without seeking.
+
+class Fat32Builder
+{
+public:
+    Fat32Builder(uint32_t sectors_per_cluster = 8);
+
+    void add_file(const std::string& name, const std::string& ext, const std::vector<uint8_t>& data);
+
+    // With size_mb = 0 the image is just large enough for the files, but at
+    // least as large as a FAT32 file system has to be. The file is written
+    // sparsely, so the unused space doesn't take up room on the disk.
+    void write(const std::string& filename, uint32_t size_mb = 0);
+
+private:
+    struct File
+    {
+        char name[11];
+        std::vector<uint8_t> data;
+    };
+
+    std::vector<File> files;
+    uint32_t sectors_per_cluster;
+
+    uint32_t clusters_for(size_t bytes) const;
+};
+
+#endif
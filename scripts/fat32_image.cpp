@@ -0,0 +1,304 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "fat32_image.h"
+
+#define END_CLUSTER_MASK 0x0FFFFFF8
+
+static const char index_name[] = "DIRINDEXIDX";
+
+
+uint32_t read_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint16_t read_le16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+void write_le32(uint8_t *p, uint32_t val)
+{
+    p[0] = val & 0xFF;
+    p[1] = (val >> 8) & 0xFF;
+    p[2] = (val >> 16) & 0xFF;
+    p[3] = (val >> 24) & 0xFF;
+}
+
+void write_le16(uint8_t *p, uint16_t val)
+{
+    p[0] = val & 0xFF;
+    p[1] = (val >> 8) & 0xFF;
+}
+
+
+std::string Fat32Image::Entry::filename() const
+{
+    std::string s;
+
+    for(int i = 0; i < 8 && name[i] != ' '; i++)
+    {
+        s += name[i];
+    }
+
+    if(name[8] != ' ')
+    {
+        s += '.';
+        for(int i = 8; i < 11 && name[i] != ' '; i++)
+        {
+            s += name[i];
+        }
+    }
+
+    return s;
+}
+
+bool Fat32Image::Entry::is_file() const
+{
+    return !(attrib & (ATTRIB_VOLUME_ID | ATTRIB_DIRECTORY));
+}
+
+
+Fat32Image::Fat32Image(const std::string& filename, bool writable)
+{
+    file = fopen(filename.c_str(), writable ? "r+b" : "rb");
+    if(!file)
+    {
+        fprintf(stderr, "Error: Could not open file %s\n", filename.c_str());
+        exit(1);
+    }
+
+    uint8_t sector[BYTES_PER_SECTOR];
+
+    // Same partition types as fat32_read_partition_table() on the controller
+    read_sector(0, sector);
+
+    uint32_t partition_start = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        const uint8_t *p = &sector[0x1BE + 16 * i];
+        if(p[4] == 0x0B || p[4] == 0x1B)
+        {
+            partition_start = read_le32(&p[8]);
+            break;
+        }
+    }
+
+    if(!partition_start || read_le16(&sector[0x1FE]) != 0xAA55)
+    {
+        fprintf(stderr, "Error: No FAT32 partition (type 0x0B) found in %s\n", filename.c_str());
+        exit(1);
+    }
+
+    read_sector(partition_start, sector);
+
+    if(read_le16(&sector[11]) != BYTES_PER_SECTOR)
+    {
+        fprintf(stderr, "Error: Expected 512 bytes per sector\n");
+        exit(1);
+    }
+
+    sectors_per_cluster = sector[13];
+    uint16_t reserved_sectors = read_le16(&sector[14]);
+    uint8_t number_of_fats = sector[16];
+    uint32_t fat_size = read_le32(&sector[36]);
+    root_dir_cluster = read_le32(&sector[44]);
+    fsinfo_sector = partition_start + read_le16(&sector[48]);
+
+    fat_start = partition_start + reserved_sectors;
+    data_start = fat_start + number_of_fats * fat_size;
+}
+
+Fat32Image::~Fat32Image()
+{
+    fclose(file);
+}
+
+void Fat32Image::read_sector(uint32_t sector, uint8_t *buf)
+{
+    if(fseek(file, (long)sector * BYTES_PER_SECTOR, SEEK_SET) || fread(buf, BYTES_PER_SECTOR, 1, file) != 1)
+    {
+        fprintf(stderr, "Error: Could not read sector %u\n", sector);
+        exit(1);
+    }
+}
+
+void Fat32Image::write_sector(uint32_t sector, const uint8_t *buf)
+{
+    if(fseek(file, (long)sector * BYTES_PER_SECTOR, SEEK_SET) || fwrite(buf, BYTES_PER_SECTOR, 1, file) != 1)
+    {
+        fprintf(stderr, "Error: Could not write sector %u\n", sector);
+        exit(1);
+    }
+}
+
+uint32_t Fat32Image::cluster_sector(uint32_t cluster) const
+{
+    return data_start + (cluster - 2) * sectors_per_cluster;
+}
+
+std::vector<uint32_t> Fat32Image::cluster_chain(uint32_t cluster)
+{
+    std::vector<uint32_t> chain;
+    uint8_t sector[BYTES_PER_SECTOR];
+
+    while(cluster >= 2 && (cluster & END_CLUSTER_MASK) != END_CLUSTER_MASK)
+    {
+        chain.push_back(cluster);
+
+        read_sector(fat_start + cluster * 4 / BYTES_PER_SECTOR, sector);
+        cluster = read_le32(&sector[cluster * 4 % BYTES_PER_SECTOR]) & 0x0FFFFFFF;
+    }
+
+    return chain;
+}
+
+std::vector<Fat32Image::Entry> Fat32Image::root_dir()
+{
+    std::vector<Entry> entries;
+    uint8_t sector[BYTES_PER_SECTOR];
+
+    for(uint32_t cluster : cluster_chain(root_dir_cluster))
+    {
+        for(uint32_t s = 0; s < sectors_per_cluster; s++)
+        {
+            read_sector(cluster_sector(cluster) + s, sector);
+
+            for(int i = 0; i < BYTES_PER_SECTOR; i += 32)
+            {
+                const uint8_t *p = &sector[i];
+
+                if(p[0] == 0x00)
+                {
+                    return entries;
+                }
+
+                if(p[0] == 0xE5 || p[11] == ATTRIB_LFN)
+                {
+                    continue;
+                }
+
+                Entry entry;
+                memcpy(entry.name, p, 11);
+                entry.attrib = p[11];
+                entry.cluster = ((uint32_t)read_le16(&p[20]) << 16) | read_le16(&p[26]);
+                entry.size = read_le32(&p[28]);
+
+                entries.push_back(entry);
+            }
+        }
+    }
+
+    return entries;
+}
+
+void Fat32Image::write_file(const Entry& entry, const std::vector<uint8_t>& data)
+{
+    std::vector<uint32_t> chain = cluster_chain(entry.cluster);
+
+    if(data.size() > entry.size || data.size() > chain.size() * bytes_per_cluster())
+    {
+        fprintf(stderr, "Error: %s is too small, it needs to be at least %lu bytes\n",
+                entry.filename().c_str(), (unsigned long)data.size());
+        exit(1);
+    }
+
+    uint8_t sector[BYTES_PER_SECTOR];
+    size_t pos = 0;
+
+    for(uint32_t cluster : chain)
+    {
+        for(uint32_t s = 0; s < sectors_per_cluster && pos < data.size(); s++)
+        {
+            size_t n = data.size() - pos < BYTES_PER_SECTOR ? data.size() - pos : BYTES_PER_SECTOR;
+
+            memset(sector, 0, sizeof(sector));
+            memcpy(sector, &data[pos], n);
+            write_sector(cluster_sector(cluster) + s, sector);
+
+            pos += n;
+        }
+    }
+}
+
+// The index starts with a 16 byte header: "DIDX", the number of entries as
+// 16-bit little endian, the size of an entry and of the header as bytes,
+// and the free cluster count and next free cluster of the FS information
+// sector as 32-bit little endian. The controller ignores the index when the
+// FS information sector no longer matches, as the directory has then been
+// changed since. It is followed by 20 byte entries sorted by name: the 8.3
+// name padded with spaces as in the directory, the attributes, and the
+// first cluster and size as 32-bit little endian.
+size_t Fat32Image::write_dir_index()
+{
+    std::vector<Entry> dir = root_dir();
+    std::vector<Entry> files;
+
+    const Entry *index_entry = 0;
+
+    for(size_t i = 0; i < dir.size(); i++)
+    {
+        if(!memcmp(dir[i].name, index_name, 11))
+        {
+            index_entry = &dir[i];
+        } else if(dir[i].is_file()) {
+            files.push_back(dir[i]);
+        }
+    }
+
+    if(!index_entry)
+    {
+        fprintf(stderr, "Error: There is no DIRINDEX.IDX in the root directory\n");
+        exit(1);
+    }
+
+    if(files.size() > 0xFFFF)
+    {
+        fprintf(stderr, "Error: Too many files\n");
+        exit(1);
+    }
+
+    std::sort(files.begin(), files.end(), [](const Entry& a, const Entry& b) {
+            return memcmp(a.name, b.name, 11) < 0;
+        });
+
+    std::vector<uint8_t> data(INDEX_HEADER_SIZE + files.size() * INDEX_ENTRY_SIZE);
+
+    uint8_t fsinfo[BYTES_PER_SECTOR];
+    read_sector(fsinfo_sector, fsinfo);
+
+    memcpy(&data[0], "DIDX", 4);
+    write_le16(&data[4], files.size());
+    data[6] = INDEX_ENTRY_SIZE;
+    data[7] = INDEX_HEADER_SIZE;
+    memcpy(&data[8], &fsinfo[488], 8);
+
+    for(size_t i = 0; i < files.size(); i++)
+    {
+        uint8_t *p = &data[INDEX_HEADER_SIZE + i * INDEX_ENTRY_SIZE];
+
+        memcpy(p, files[i].name, 11);
+        p[11] = files[i].attrib;
+        write_le32(&p[12], files[i].cluster);
+        write_le32(&p[16], files[i].size);
+    }
+
+    std::vector<uint32_t> chain = cluster_chain(index_entry->cluster);
+
+    for(size_t i = 1; i < chain.size(); i++)
+    {
+        if(chain[i] != chain[i - 1] + 1)
+        {
+            fprintf(stderr, "Warning: DIRINDEX.IDX is fragmented, the controller will scan the directory\n");
+            break;
+        }
+    }
+
+    write_file(*index_entry, data);
+
+    return files.size();
+}
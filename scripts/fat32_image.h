@@ -0,0 +1,77 @@
+#ifndef FAT32_IMAGE_H_
+#define FAT32_IMAGE_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// Access to the FAT32 file system of an SD card image or block device, laid
+// out the way the controller expects it: an MBR with a FAT32 partition
+
+class Fat32Image
+{
+public:
+    enum
+    {
+        BYTES_PER_SECTOR = 512,
+
+        ATTRIB_VOLUME_ID = 0x08,
+        ATTRIB_DIRECTORY = 0x10,
+        ATTRIB_LFN = 0x0F,
+
+        INDEX_HEADER_SIZE = 16,
+        INDEX_ENTRY_SIZE = 20
+    };
+
+    struct Entry
+    {
+        char name[11]; // 8.3 name padded with spaces, as in the directory
+        uint8_t attrib;
+        uint32_t cluster;
+        uint32_t size;
+
+        std::string filename() const; // NAME.EXT
+        bool is_file() const;
+    };
+
+    Fat32Image(const std::string& filename, bool writable = false);
+    ~Fat32Image();
+
+    std::vector<Entry> root_dir();
+    std::vector<uint32_t> cluster_chain(uint32_t cluster);
+
+    // Overwrite the start of the file with data, which must fit in its clusters
+    void write_file(const Entry& entry, const std::vector<uint8_t>& data);
+
+    // Write the sorted index of the root directory to DIRINDEX.IDX, which has
+    // to exist already, and be contiguous for the controller to use it.
+    // Returns the number of files in the index.
+    size_t write_dir_index();
+
+    uint32_t bytes_per_cluster() const { return sectors_per_cluster * BYTES_PER_SECTOR; }
+
+    // Sector of the FAT holding the entry of cluster
+    uint32_t fat_sector(uint32_t cluster) const { return fat_start + cluster * 4 / BYTES_PER_SECTOR; }
+
+private:
+    FILE *file;
+
+    uint32_t fat_start;
+    uint32_t data_start;
+    uint32_t root_dir_cluster;
+    uint32_t sectors_per_cluster;
+    uint32_t fsinfo_sector;
+
+    void read_sector(uint32_t sector, uint8_t *buf);
+    void write_sector(uint32_t sector, const uint8_t *buf);
+    uint32_t cluster_sector(uint32_t cluster) const;
+};
+
+uint32_t read_le32(const uint8_t *p);
+uint16_t read_le16(const uint8_t *p);
+void write_le32(uint8_t *p, uint32_t val);
+void write_le16(uint8_t *p, uint16_t val);
+
+#endif
@@ -290,6 +290,12 @@ void Nes_Apu::bank_switch( nes_time_t time, long total_time, int slot, int bank
 	reg_writes.push_back(b);
 }
 
+void Nes_Apu::expansion_write( nes_time_t time, long total_time, int bus_addr, int data )
+{
+	RegWrite r = { total_time + time, bus_addr, data };
+	reg_writes.push_back(r);
+}
+
 
 void Nes_Apu::write_register( nes_time_t time, long total_time, nes_addr_t addr, int data )
 {
@@ -41,6 +41,10 @@ public:
 	enum { end_addr   = 0x4017 };
 	void write_register( nes_time_t, long total_time, nes_addr_t, int data );
 	void bank_switch( nes_time_t t, long total_time, int slot, int bank);
+
+	// Record a write to an expansion chip, with its address on the NESSynth
+	// bus (see lib/bus.h)
+	void expansion_write( nes_time_t t, long total_time, int bus_addr, int data );
 	
 	// Read from status register at 0x4015
 	enum { status_addr = 0x4015 };
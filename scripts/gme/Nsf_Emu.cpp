@@ -6,6 +6,8 @@
 #include <string.h>
 #include <stdio.h>
 
+#include "../../lib/bus.h"
+
 #if !NSF_EMU_APU_ONLY
 	#include "Nes_Namco_Apu.h"
 	#include "Nes_Vrc6_Apu.h"
@@ -44,6 +46,7 @@ Nsf_Emu::Nsf_Emu()
 	vrc6  = 0;
 	namco = 0;
 	fme7  = 0;
+	fme7_latch = 0;
 	
 	set_type( gme_nsf_type );
 	set_silence_lookahead( 6 );
@@ -406,9 +409,12 @@ void Nsf_Emu::cpu_write_misc( nes_addr_t addr, int data )
 			{
 			case Nes_Fme7_Apu::latch_addr:
 				fme7->write_latch( data );
+				fme7_latch = data;
 				return;
 			
 			case Nes_Fme7_Apu::data_addr:
+				if ( (unsigned) fme7_latch < fme7_apu_state_t::reg_count )
+					apu.expansion_write( time(), cpu::total_time(), BUS_FME7 + fme7_latch, data );
 				fme7->write_data( time(), data );
 				return;
 			}
@@ -420,6 +426,7 @@ void Nsf_Emu::cpu_write_misc( nes_addr_t addr, int data )
 			unsigned osc = unsigned (addr - Nes_Vrc6_Apu::base_addr) / Nes_Vrc6_Apu::addr_step;
 			if ( osc < Nes_Vrc6_Apu::osc_count && reg < Nes_Vrc6_Apu::reg_count )
 			{
+				apu.expansion_write( time(), cpu::total_time(), BUS_VRC6 + 4 * osc + reg, data );
 				vrc6->write_osc( time(), osc, reg, data );
 				return;
 			}
@@ -94,6 +94,7 @@ private:
 	class Nes_Namco_Apu* namco;
 	class Nes_Vrc6_Apu*  vrc6;
 	class Nes_Fme7_Apu*  fme7;
+	int fme7_latch;
 	Nes_Apu apu;
 	static int pcm_read( void*, nes_addr_t );
 	blargg_err_t init_sound();
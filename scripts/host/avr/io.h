@@ -0,0 +1,8 @@
+#ifndef HOST_IO_H_
+#define HOST_IO_H_
+
+#include <stdint.h>
+
+#define _BV(b) (1 << (b))
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef HOST_PGMSPACE_H_
+#define HOST_PGMSPACE_H_
+
+// Flash and RAM are the same on the host
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+
+#define memcmp_P memcmp
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+
+#endif
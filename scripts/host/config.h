@@ -0,0 +1,10 @@
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+// Configuration for building the controller's FAT32 driver on the host, see
+// sd_image.c
+
+#include <avr/pgmspace.h>
+#include <avr/io.h>
+
+#endif
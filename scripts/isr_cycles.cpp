@@ -0,0 +1,902 @@
+// Worst case cycle counts of the interrupt handlers in a firmware listing,
+// the .lss file from the lss target of lib/Makefile.inc (avr-objdump -h -S).
+//
+// Every path from the vector to reti is followed, taking the longer side of
+// each branch and skip, and adding the worst case of any called function.
+// The counts include the 4 cycles to enter the interrupt and the jump in the
+// vector table. Paths with a loop or an indirect jump have no bound.
+//
+// Budgets are given as -b VECTOR=CYCLES, or -b VECTOR+VECTOR=CYCLES for the
+// sum, with the names from avr/io.h (e.g. TIMER1_COMPA_vect). The exit
+// status is 1 if any budget is exceeded, and the worst path is printed.
+//
+// With -o PORT, the fewest and most cycles from the interrupt to the first
+// out to the I/O address PORT are printed as well. The difference is the
+// jitter of that output relative to the interrupt, on top of the latency of
+// the interrupt itself.
+//
+// A path that runs too rarely to count against the budget of every
+// interrupt, such as wrapping around a table, is left out with -r LABEL,
+// where LABEL is a symbol of the listing. The worst case through it is
+// printed as VECTOR:LABEL, which can have a budget of its own, alone or in
+// a sum.
+//
+// A handler that is meant to run for as long as it takes, such as one that
+// enables interrupts and loops over a buffer, is marked with -u VECTOR. It
+// is reported as unbounded by design and can't be part of a budget.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Vector numbers of the ATmega48/88/168/328
+static const char *vector_names[] = {
+    "RESET", "INT0_vect", "INT1_vect", "PCINT0_vect", "PCINT1_vect", "PCINT2_vect", "WDT_vect",
+    "TIMER2_COMPA_vect", "TIMER2_COMPB_vect", "TIMER2_OVF_vect", "TIMER1_CAPT_vect",
+    "TIMER1_COMPA_vect", "TIMER1_COMPB_vect", "TIMER1_OVF_vect", "TIMER0_COMPA_vect",
+    "TIMER0_COMPB_vect", "TIMER0_OVF_vect", "SPI_STC_vect", "USART_RX_vect", "USART_UDRE_vect",
+    "USART_TX_vect", "ADC_vect", "EE_READY_vect", "ANALOG_COMP_vect", "TWI_vect", "SPM_READY_vect"
+};
+
+#define NUM_VECTORS (sizeof(vector_names) / sizeof(vector_names[0]))
+
+#define INTERRUPT_ENTRY_CYCLES 4
+
+enum { UNBOUNDED = -1 };
+
+struct Instruction
+{
+    unsigned long addr;
+    unsigned size;     // Bytes
+    std::string op;
+    std::string args;
+    unsigned long target; // Of a jump, branch or call
+    std::string line;
+};
+
+class Listing
+{
+public:
+    Listing(const char *filename);
+
+    // Worst case cycles from addr to the end of the handler or function,
+    // or UNBOUNDED
+    long worst(unsigned long addr);
+
+    // Instructions along the worst path from addr
+    void print_path(unsigned long addr);
+
+    // Address of the handler of vector n and the cycles of its vector table
+    // entry, or false if the entry just goes to __bad_interrupt
+    bool vector(unsigned n, unsigned long *addr, unsigned *cycles);
+
+    std::string problem(unsigned long addr) const;
+
+    // Address of the symbol name, or false if there is none
+    bool symbol(const std::string& name, unsigned long *addr) const;
+
+    // Leave the paths through addrs out of worst() and out_latency()
+    void exclude(const std::set<unsigned long>& addrs);
+
+    // Fewest and most cycles from addr to the first out to the I/O address
+    // port, over the paths that reach one. The most is UNBOUNDED if a loop
+    // comes first. False if no path reaches one.
+    bool out_latency(unsigned long addr, unsigned port, long *min, long *max);
+
+private:
+    std::map<unsigned long, Instruction> code;
+    std::map<unsigned long, std::string> symbols;
+    std::vector<Instruction> vectors;
+
+    std::map<unsigned long, long> memo;
+    std::map<unsigned long, unsigned long> next_on_path; // Worst successor
+    std::map<unsigned long, std::string> problems;       // Why a path is unbounded
+    std::set<unsigned long> visiting;
+    std::set<unsigned long> excluded;
+
+    struct Latency
+    {
+        bool found;
+        bool loop;   // A path from here goes back to a node being visited
+        long min, max;
+    };
+
+    std::map<unsigned long, Latency> latency_memo;
+    Latency latency(unsigned long addr, unsigned port);
+
+    struct Edge
+    {
+        unsigned long target;
+        unsigned cycles;
+        bool call;         // target is a function, continue at the next instruction
+    };
+
+    bool edges(const Instruction& ins, std::vector<Edge>& out, std::string& problem);
+    unsigned long next_addr(unsigned long addr) const;
+};
+
+static bool starts_with(const std::string& s, const char *prefix)
+{
+    return !s.compare(0, strlen(prefix), prefix);
+}
+
+Listing::Listing(const char *filename)
+{
+    FILE *f = fopen(filename, "r");
+    if(!f)
+    {
+        fprintf(stderr, "Error: Could not open file %s\n", filename);
+        exit(1);
+    }
+
+    char buf[512];
+    std::string symbol;
+
+    while(fgets(buf, sizeof(buf), f))
+    {
+        std::string line(buf);
+        line.erase(line.find_last_not_of("\r\n") + 1);
+
+        unsigned long addr;
+        char name[256];
+
+        // 00000068 <__vector_3>:
+        if(sscanf(buf, "%lx <%255[^>]>:", &addr, name) == 2 && buf[0] != ' ')
+        {
+            symbol = name;
+            symbols[addr] = symbol;
+            continue;
+        }
+
+        //   68:	1f 92       	push	r1
+        size_t tab1 = line.find('\t');
+        size_t colon = line.find(':');
+        if(tab1 == std::string::npos || colon == std::string::npos || colon > tab1 || line[0] != ' ')
+        {
+            continue;
+        }
+
+        if(sscanf(line.c_str(), "%lx:", &addr) != 1)
+        {
+            continue;
+        }
+
+        size_t tab2 = line.find('\t', tab1 + 1);
+        if(tab2 == std::string::npos)
+        {
+            continue;
+        }
+
+        std::string bytes = line.substr(tab1 + 1, tab2 - tab1 - 1);
+        std::string rest = line.substr(tab2 + 1);
+
+        Instruction ins;
+        ins.addr = addr;
+        ins.size = 0;
+        ins.target = 0;
+        ins.line = line;
+
+        for(size_t i = 0; i + 1 < bytes.size(); i += 3)
+        {
+            if(bytes[i] != ' ')
+            {
+                ins.size++;
+            }
+        }
+
+        size_t tab3 = rest.find('\t');
+        ins.op = rest.substr(0, tab3);
+        ins.args = tab3 == std::string::npos ? "" : rest.substr(tab3 + 1);
+
+        // Targets are given as an absolute address in the comment:
+        // rjmp .+4 ; 0x70 <foo+0x4>, call 0x68 ; 0x68 <bar>
+        size_t comment = ins.args.find("; 0x");
+        if(comment != std::string::npos)
+        {
+            ins.target = strtoul(ins.args.c_str() + comment + 2, 0, 16);
+        } else if(starts_with(ins.args, "0x")) {
+            ins.target = strtoul(ins.args.c_str(), 0, 16);
+        }
+
+        if(!ins.size || ins.op.empty())
+        {
+            continue;
+        }
+
+        if(symbol == "__vectors")
+        {
+            vectors.push_back(ins);
+        }
+
+        code[addr] = ins;
+    }
+
+    fclose(f);
+
+    if(vectors.empty())
+    {
+        fprintf(stderr, "Error: No vector table in %s\n", filename);
+        exit(1);
+    }
+}
+
+unsigned long Listing::next_addr(unsigned long addr) const
+{
+    auto it = code.find(addr);
+    return it->first + it->second.size;
+}
+
+static bool is_one_of(const std::string& op, const char *const *ops)
+{
+    for(; *ops; ops++)
+    {
+        if(op == *ops)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Cycles of the classic AVR core, as in the ATmega88/328 instruction set
+// summary. Branches, skips and control flow are handled in edges().
+static unsigned cycles(const std::string& op)
+{
+    static const char *const two[] = {
+        "adiw", "sbiw", "mul", "muls", "mulsu", "fmul", "fmuls", "fmulsu",
+        "ld", "ldd", "lds", "st", "std", "sts", "push", "pop", "sbi", "cbi", 0
+    };
+    static const char *const three[] = { "lpm", "elpm", 0 };
+
+    if(is_one_of(op, two))
+    {
+        return 2;
+    }
+    if(is_one_of(op, three))
+    {
+        return 3;
+    }
+    return 1;
+}
+
+bool Listing::edges(const Instruction& ins, std::vector<Edge>& out, std::string& problem)
+{
+    static const char *const skips[] = { "cpse", "sbrc", "sbrs", "sbic", "sbis", 0 };
+    const std::string& op = ins.op;
+    unsigned long next = ins.addr + ins.size;
+
+    if(op == "reti" || op == "ret")
+    {
+        return true;
+    }
+
+    if(op == "rjmp" || op == "jmp")
+    {
+        out.push_back({ins.target, op == "rjmp" ? 2u : 3u, false});
+    } else if(op == "rcall" || op == "call") {
+        out.push_back({ins.target, op == "rcall" ? 3u : 4u, true});
+    } else if(op == "ijmp" || op == "icall" || op == "eijmp" || op == "eicall") {
+        problem = "indirect " + op;
+        return false;
+    } else if(starts_with(op, "br") && op != "break") {
+        out.push_back({next, 1, false});
+        out.push_back({ins.target, 2, false});
+    } else if(is_one_of(op, skips)) {
+        if(!code.count(next))
+        {
+            problem = "skip past the end of the code";
+            return false;
+        }
+        unsigned skipped = code[next].size;
+        out.push_back({next, 1, false});
+        out.push_back({next + skipped, skipped == 4 ? 3u : 2u, false});
+    } else {
+        out.push_back({next, cycles(op), false});
+    }
+
+    for(const Edge& e : out)
+    {
+        if(!code.count(e.target))
+        {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "jump to unknown address 0x%lx", e.target);
+            problem = buf;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+long Listing::worst(unsigned long addr)
+{
+    auto m = memo.find(addr);
+    if(m != memo.end())
+    {
+        return m->second;
+    }
+
+    if(visiting.count(addr))
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "loop at 0x%lx", addr);
+        problems[addr] = buf;
+        return UNBOUNDED;
+    }
+
+    const Instruction& ins = code.at(addr);
+    std::vector<Edge> out;
+    std::string problem;
+
+    visiting.insert(addr);
+
+    long result;
+
+    if(!edges(ins, out, problem))
+    {
+        problems[addr] = problem;
+        result = UNBOUNDED;
+    } else if(out.empty()) {
+        result = 4; // ret, reti
+    } else {
+        result = 0;
+
+        for(const Edge& e : out)
+        {
+            long c;
+
+            if(excluded.count(e.target))
+            {
+                continue;
+            }
+
+            if(e.call)
+            {
+                long callee = worst(e.target);
+                long rest = worst(next_addr(addr));
+
+                c = (callee == UNBOUNDED || rest == UNBOUNDED) ? UNBOUNDED : e.cycles + callee + rest;
+                if(callee == UNBOUNDED)
+                {
+                    problems[addr] = problems[e.target];
+                } else if(rest == UNBOUNDED) {
+                    problems[addr] = problems[next_addr(addr)];
+                }
+            } else {
+                long rest = worst(e.target);
+                c = rest == UNBOUNDED ? UNBOUNDED : e.cycles + rest;
+            }
+
+            if(c == UNBOUNDED)
+            {
+                if(!problems.count(addr) && problems.count(e.target))
+                {
+                    problems[addr] = problems[e.target];
+                }
+                result = UNBOUNDED;
+                break;
+            }
+
+            if(c > result)
+            {
+                result = c;
+                next_on_path[addr] = e.call ? next_addr(addr) : e.target;
+            }
+        }
+    }
+
+    visiting.erase(addr);
+
+    // Every node that reaches a loop is unbounded itself, and a bounded
+    // result never depends on the nodes still being visited
+    memo[addr] = result;
+
+    return result;
+}
+
+std::string Listing::problem(unsigned long addr) const
+{
+    auto it = problems.find(addr);
+    return it == problems.end() ? "" : it->second;
+}
+
+bool Listing::symbol(const std::string& name, unsigned long *addr) const
+{
+    for(const auto& s : symbols)
+    {
+        if(s.second == name)
+        {
+            *addr = s.first;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Listing::exclude(const std::set<unsigned long>& addrs)
+{
+    if(addrs == excluded)
+    {
+        return;
+    }
+
+    excluded = addrs;
+
+    memo.clear();
+    next_on_path.clear();
+    problems.clear();
+    latency_memo.clear();
+}
+
+Listing::Latency Listing::latency(unsigned long addr, unsigned port)
+{
+    auto m = latency_memo.find(addr);
+    if(m != latency_memo.end())
+    {
+        return m->second;
+    }
+
+    Latency result = { false, false, 0, 0 };
+
+    const Instruction& ins = code.at(addr);
+
+    if(ins.op == "out" && strtoul(ins.args.c_str(), 0, 0) == port)
+    {
+        result.found = true;
+        return latency_memo[addr] = result;
+    }
+
+    if(visiting.count(addr))
+    {
+        result.loop = true;
+        return result;
+    }
+
+    std::vector<Edge> out;
+    std::string problem;
+
+    visiting.insert(addr);
+
+    if(edges(ins, out, problem))
+    {
+        for(const Edge& e : out)
+        {
+            long cycles = e.cycles;
+            unsigned long target = e.target;
+
+            if(excluded.count(e.target))
+            {
+                continue;
+            }
+
+            if(e.call)
+            {
+                long callee = worst(e.target);
+                cycles = callee == UNBOUNDED ? UNBOUNDED : cycles + callee;
+                target = next_addr(addr);
+            }
+
+            Latency rest = latency(target, port);
+            result.loop |= rest.loop;
+
+            if(!rest.found)
+            {
+                continue;
+            }
+
+            long min = rest.min + (cycles == UNBOUNDED ? 0 : cycles);
+            long max = (rest.max == UNBOUNDED || cycles == UNBOUNDED) ? UNBOUNDED : rest.max + cycles;
+
+            if(!result.found)
+            {
+                result.min = min;
+                result.max = max;
+            } else {
+                result.min = std::min(result.min, min);
+                result.max = (result.max == UNBOUNDED || max == UNBOUNDED) ? UNBOUNDED : std::max(result.max, max);
+            }
+            result.found = true;
+        }
+    }
+
+    visiting.erase(addr);
+
+    // The out can come after any number of turns of the loop
+    if(result.found && result.loop)
+    {
+        result.max = UNBOUNDED;
+    }
+
+    latency_memo[addr] = result;
+
+    return result;
+}
+
+bool Listing::out_latency(unsigned long addr, unsigned port, long *min, long *max)
+{
+    Latency l = latency(addr, port);
+
+    *min = l.min;
+    *max = l.max;
+
+    return l.found;
+}
+
+void Listing::print_path(unsigned long addr)
+{
+    for(int n = 0; n < 1000; n++)
+    {
+        if(symbols.count(addr))
+        {
+            printf("    <%s>:\n", symbols[addr].c_str());
+        }
+
+        const Instruction& ins = code.at(addr);
+        printf("    %s\n", ins.line.c_str());
+
+        if(ins.op == "call" || ins.op == "rcall")
+        {
+            printf("        (calls <%s>, %ld cycles)\n",
+                   symbols.count(ins.target) ? symbols[ins.target].c_str() : "?", worst(ins.target));
+        }
+
+        auto it = next_on_path.find(addr);
+        if(it == next_on_path.end())
+        {
+            break;
+        }
+        addr = it->second;
+    }
+}
+
+bool Listing::vector(unsigned n, unsigned long *addr, unsigned *entry_cycles)
+{
+    if(n >= vectors.size())
+    {
+        return false;
+    }
+
+    const Instruction& ins = vectors[n];
+    *addr = ins.target;
+    *entry_cycles = INTERRUPT_ENTRY_CYCLES + (ins.op == "jmp" ? 3 : 2);
+
+    return symbols.count(ins.target) && symbols[ins.target] != "__bad_interrupt";
+}
+
+
+// A vector, and the path left out with -r that it may take
+struct Term
+{
+    unsigned vector;
+    std::string rare;
+};
+
+struct Budget
+{
+    std::string spec;
+    std::vector<Term> terms;
+    long cycles;
+};
+
+static int vector_number(const std::string& name)
+{
+    for(unsigned i = 0; i < NUM_VECTORS; i++)
+    {
+        if(name == vector_names[i])
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// The addresses of the paths left out with -r, but for the one through allowed
+static std::set<unsigned long> exclusions(const std::map<std::string, unsigned long>& rare, const std::string& allowed)
+{
+    std::set<unsigned long> addrs;
+
+    for(const auto& r : rare)
+    {
+        if(r.first != allowed)
+        {
+            addrs.insert(r.second);
+        }
+    }
+
+    return addrs;
+}
+
+// Worst case cycles of the handler at addr, including the entry
+static long vector_worst(Listing& listing, unsigned long addr, unsigned entry,
+                         const std::map<std::string, unsigned long>& rare, const std::string& allowed)
+{
+    listing.exclude(exclusions(rare, allowed));
+
+    long w = listing.worst(addr);
+    return w == UNBOUNDED ? UNBOUNDED : w + entry;
+}
+
+void print_usage(char *p)
+{
+    fprintf(stderr, "Usage: %s [-b VECTOR[:LABEL][+VECTOR[:LABEL]...]=CYCLES]... [-r LABEL]... [-u VECTOR]... [-o PORT] file.lss\n"
+            "Print the worst case cycles of each interrupt handler in file.lss, and\n"
+            "exit with an error if one is over its budget. With -o, also print the\n"
+            "cycles to the first out to the I/O address PORT, e.g. 0x08 for PORTC.\n"
+            "With -r, the paths through LABEL are left out, and VECTOR:LABEL is the\n"
+            "worst case through it. -u marks a handler as unbounded by design.\n", p);
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<Budget> budgets;
+    std::vector<std::string> rare_names;
+    std::set<unsigned> unbounded;
+    long port = -1;
+    int c;
+
+    while((c = getopt(argc, argv, "b:r:u:o:")) != -1)
+    {
+        switch(c)
+        {
+        case 'b':
+        {
+            Budget b;
+            b.spec = optarg;
+
+            size_t eq = b.spec.find('=');
+            if(eq == std::string::npos)
+            {
+                print_usage(argv[0]);
+                exit(1);
+            }
+
+            b.cycles = atol(b.spec.c_str() + eq + 1);
+
+            std::string names = b.spec.substr(0, eq);
+            size_t pos = 0;
+
+            while(pos <= names.size())
+            {
+                size_t plus = names.find('+', pos);
+                std::string name = names.substr(pos, plus == std::string::npos ? std::string::npos : plus - pos);
+                Term term;
+
+                size_t colon = name.find(':');
+                if(colon != std::string::npos)
+                {
+                    term.rare = name.substr(colon + 1);
+                    name = name.substr(0, colon);
+                }
+
+                int n = vector_number(name);
+
+                if(n < 0)
+                {
+                    fprintf(stderr, "Error: Unknown vector %s\n", name.c_str());
+                    exit(1);
+                }
+
+                term.vector = n;
+                b.terms.push_back(term);
+
+                if(plus == std::string::npos)
+                {
+                    break;
+                }
+                pos = plus + 1;
+            }
+
+            budgets.push_back(b);
+            break;
+        }
+
+        case 'r':
+            rare_names.push_back(optarg);
+            break;
+
+        case 'u':
+        {
+            int n = vector_number(optarg);
+
+            if(n < 0)
+            {
+                fprintf(stderr, "Error: Unknown vector %s\n", optarg);
+                exit(1);
+            }
+            unbounded.insert(n);
+            break;
+        }
+
+        case 'o':
+            port = strtoul(optarg, 0, 0);
+            break;
+
+        default:
+            print_usage(argv[0]);
+            exit(1);
+        }
+    }
+
+    if(optind != argc - 1)
+    {
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    Listing listing(argv[optind]);
+
+    std::map<std::string, unsigned long> rare;
+
+    for(const std::string& name : rare_names)
+    {
+        unsigned long addr;
+
+        if(!listing.symbol(name, &addr))
+        {
+            fprintf(stderr, "Error: There is no symbol %s\n", name.c_str());
+            exit(1);
+        }
+        rare[name] = addr;
+    }
+
+    for(const Budget& b : budgets)
+    {
+        for(const Term& t : b.terms)
+        {
+            if(!t.rare.empty() && !rare.count(t.rare))
+            {
+                fprintf(stderr, "Error: %s is not left out with -r\n", t.rare.c_str());
+                exit(1);
+            }
+
+            if(unbounded.count(t.vector))
+            {
+                fprintf(stderr, "Error: %s is unbounded by design\n", vector_names[t.vector]);
+                exit(1);
+            }
+        }
+    }
+
+    printf("%-28s %8s", "Vector", "Cycles");
+    if(port >= 0)
+    {
+        printf("  %-16s %s", "Out", "Jitter");
+    }
+    printf("\n");
+
+    for(unsigned n = 1; n < NUM_VECTORS; n++)
+    {
+        unsigned long addr;
+        unsigned entry;
+
+        if(!listing.vector(n, &addr, &entry))
+        {
+            continue;
+        }
+
+        long w = vector_worst(listing, addr, entry, rare, "");
+
+        printf("%-28s ", vector_names[n]);
+
+        if(w == UNBOUNDED)
+        {
+            printf("%8s", "-");
+        } else {
+            printf("%8ld", w);
+        }
+
+        long min, max;
+
+        if(port >= 0 && listing.out_latency(addr, port, &min, &max))
+        {
+            char out[32];
+
+            if(max == UNBOUNDED)
+            {
+                snprintf(out, sizeof(out), "%ld-", min + entry);
+                printf("  %-16s %s", out, "-");
+            } else {
+                snprintf(out, sizeof(out), "%ld-%ld", min + entry, max + entry);
+                printf("  %-16s %ld", out, max - min);
+            }
+        }
+
+        if(w == UNBOUNDED)
+        {
+            printf("  (%s%s)", unbounded.count(n) ? "by design, " : "", listing.problem(addr).c_str());
+        } else if(unbounded.count(n)) {
+            printf("  (bounded, but marked with -u)");
+        }
+        printf("\n");
+
+        // The paths left out, where they make it longer
+        for(const auto& r : rare)
+        {
+            long rw = vector_worst(listing, addr, entry, rare, r.first);
+
+            if(rw != w && w != UNBOUNDED)
+            {
+                std::string name = std::string(vector_names[n]) + ":" + r.first;
+
+                if(rw == UNBOUNDED)
+                {
+                    printf("%-28s %8s  (%s)\n", name.c_str(), "-", listing.problem(addr).c_str());
+                } else {
+                    printf("%-28s %8ld\n", name.c_str(), rw);
+                }
+            }
+        }
+    }
+
+    int failed = 0;
+
+    if(!budgets.empty())
+    {
+        printf("\n%-56s %8s %8s\n", "Budget", "Cycles", "Limit");
+    }
+
+    for(const Budget& b : budgets)
+    {
+        long total = 0;
+
+        for(const Term& t : b.terms)
+        {
+            unsigned long addr;
+            unsigned entry;
+
+            if(!listing.vector(t.vector, &addr, &entry))
+            {
+                fprintf(stderr, "Error: There is no handler for %s\n", vector_names[t.vector]);
+                exit(1);
+            }
+
+            long w = vector_worst(listing, addr, entry, rare, t.rare);
+
+            if(w == UNBOUNDED || total == UNBOUNDED)
+            {
+                total = UNBOUNDED;
+            } else {
+                total += w;
+            }
+        }
+
+        std::string names = b.spec.substr(0, b.spec.find('='));
+        bool ok = total != UNBOUNDED && total <= b.cycles;
+
+        if(total == UNBOUNDED)
+        {
+            printf("%-56s %8s %8ld  FAIL\n", names.c_str(), "-", b.cycles);
+        } else {
+            printf("%-56s %8ld %8ld  %s\n", names.c_str(), total, b.cycles, ok ? "ok" : "FAIL");
+        }
+
+        if(!ok)
+        {
+            failed = 1;
+
+            for(const Term& t : b.terms)
+            {
+                unsigned long addr;
+                unsigned entry;
+
+                listing.vector(t.vector, &addr, &entry);
+                listing.exclude(exclusions(rare, t.rare));
+                listing.worst(addr);
+
+                printf("\n  Worst path of %s%s%s, %u cycles to enter:\n", vector_names[t.vector],
+                       t.rare.empty() ? "" : ":", t.rare.c_str(), entry);
+                listing.print_path(addr);
+            }
+            printf("\n");
+        }
+    }
+
+    return failed;
+}
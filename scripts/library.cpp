@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <algorithm>
+
+#include "library.h"
+#include "fat32_image.h"
+
+
+static void write_padded(uint8_t *p, const std::string& s, size_t len)
+{
+    memset(p, ' ', len);
+    memcpy(p, s.c_str(), s.size() < len ? s.size() : len);
+}
+
+
+void Library::add_track(const std::string& game, const std::string& filename, const std::string& title)
+{
+    if(filename.empty() || filename.size() > FILENAME_LEN)
+    {
+        fprintf(stderr, "Error: The file name '%s' does not fit in 8 characters\n", filename.c_str());
+        exit(1);
+    }
+
+    auto it = std::find_if(games.begin(), games.end(), [&](const Game& g) { return g.title == game; });
+
+    if(it == games.end())
+    {
+        games.push_back(Game());
+        games.back().title = game;
+        it = games.end() - 1;
+    }
+
+    Track track;
+    track.filename = filename;
+    track.title = title;
+
+    if(track.title.empty())
+    {
+        char buf[TITLE_LEN + 1];
+        snprintf(buf, sizeof(buf), "Track %lu", (unsigned long)it->tracks.size() + 1);
+        track.title = buf;
+    }
+
+    it->tracks.push_back(track);
+}
+
+size_t Library::num_tracks() const
+{
+    size_t n = 0;
+
+    for(const Game& game : games)
+    {
+        n += game.tracks.size();
+    }
+
+    return n;
+}
+
+// Games whose title doesn't start with a letter are listed under '#'
+char Library::letter(const std::string& title)
+{
+    if(!title.empty() && isalpha((unsigned char)title[0]))
+    {
+        return toupper((unsigned char)title[0]);
+    }
+    return '#';
+}
+
+std::vector<Library::Game> Library::sorted_games() const
+{
+    std::vector<Game> sorted = games;
+
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Game& a, const Game& b) {
+            if(letter(a.title) != letter(b.title))
+            {
+                return letter(a.title) < letter(b.title);
+            }
+            return strcasecmp(a.title.c_str(), b.title.c_str()) < 0;
+        });
+
+    return sorted;
+}
+
+std::vector<uint8_t> Library::build() const
+{
+    std::vector<Game> sorted = sorted_games();
+
+    if(sorted.size() > 0xFFFF)
+    {
+        fprintf(stderr, "Error: Too many games\n");
+        exit(1);
+    }
+
+    std::vector<char> letters;
+    for(const Game& game : sorted)
+    {
+        if(game.tracks.size() > 0xFFFF)
+        {
+            fprintf(stderr, "Error: Too many tracks in %s\n", game.title.c_str());
+            exit(1);
+        }
+
+        if(letters.empty() || letters.back() != letter(game.title))
+        {
+            letters.push_back(letter(game.title));
+        }
+    }
+
+    size_t tracks = num_tracks();
+
+    uint32_t letter_table = HEADER_LEN;
+    uint32_t game_table = letter_table + letters.size() * RECORD_LEN;
+    uint32_t track_table = game_table + sorted.size() * RECORD_LEN;
+
+    std::vector<uint8_t> data(track_table + tracks * RECORD_LEN, 0);
+
+    memcpy(&data[0], "NLIB", 4);
+    write_le16(&data[4], RECORD_LEN);
+    write_le16(&data[6], letters.size());
+    write_le16(&data[8], sorted.size());
+    write_le32(&data[12], tracks);
+    write_le32(&data[16], letter_table);
+    write_le32(&data[20], game_table);
+    write_le32(&data[24], track_table);
+
+    size_t game_num = 0;
+    size_t track_num = 0;
+
+    for(size_t l = 0; l < letters.size(); l++)
+    {
+        uint8_t *p = &data[letter_table + l * RECORD_LEN];
+        size_t first_game = game_num;
+
+        for(; game_num < sorted.size() && letter(sorted[game_num].title) == letters[l]; game_num++)
+        {
+            const Game& game = sorted[game_num];
+            uint8_t *q = &data[game_table + game_num * RECORD_LEN];
+
+            write_padded(q, game.title, TITLE_LEN);
+            write_le32(&q[20], track_num);
+            write_le16(&q[24], game.tracks.size());
+
+            for(const Track& track : game.tracks)
+            {
+                uint8_t *r = &data[track_table + track_num * RECORD_LEN];
+
+                write_padded(r, track.title, TITLE_LEN);
+                write_padded(&r[20], track.filename, FILENAME_LEN);
+
+                track_num++;
+            }
+        }
+
+        char title[TITLE_LEN + 1];
+        snprintf(title, sizeof(title), "%c%*lu", letters[l], TITLE_LEN - 1, (unsigned long)(game_num - first_game));
+
+        write_padded(p, title, TITLE_LEN);
+        write_le32(&p[20], first_game);
+        write_le16(&p[24], game_num - first_game);
+    }
+
+    return data;
+}
@@ -0,0 +1,60 @@
+#ifndef LIBRARY_H_
+#define LIBRARY_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// Builds LIBRARY.MNU, the song library read by controller/library.c.
+//
+// The file starts with a 32 byte header: "NLIB", the record length, the
+// number of letters and games as 16-bit little endian, two reserved bytes,
+// the number of tracks and the file offsets of the letter, game and track
+// tables as 32-bit little endian. Each table is an array of 32 byte records
+// starting with a 20 character title padded with spaces. Letter and game
+// records continue with the index of their first game or track (32-bit) and
+// the number of them (16-bit), track records with the song file name without
+// extension, padded with spaces to 8 characters.
+
+class Library
+{
+public:
+    enum
+    {
+        HEADER_LEN = 32,
+        RECORD_LEN = 32,
+        TITLE_LEN = 20,
+        FILENAME_LEN = 8
+    };
+
+    struct Track
+    {
+        std::string title;
+        std::string filename;
+    };
+
+    struct Game
+    {
+        std::string title;
+        std::vector<Track> tracks;
+    };
+
+    // Tracks are kept in the order they are added, games are sorted by title
+    void add_track(const std::string& game, const std::string& filename, const std::string& title = "");
+
+    std::vector<uint8_t> build() const;
+
+    // The games in the order they are stored in the library
+    std::vector<Game> sorted_games() const;
+
+    size_t num_games() const { return games.size(); }
+    size_t num_tracks() const;
+
+private:
+    std::vector<Game> games;
+
+    static char letter(const std::string& title);
+};
+
+#endif
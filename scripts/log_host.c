@@ -0,0 +1,108 @@
+// The logging functions of lib/log.c for host builds of the firmware
+// libraries, writing to stderr when log_host_enabled is set
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <avr/io.h>
+
+#include "log.h"
+
+int log_host_enabled = 0;
+
+void log_init(uint8_t mask)
+{
+}
+
+void log_enable(uint8_t mask)
+{
+}
+
+void log_disable(uint8_t mask)
+{
+}
+
+void log_putc(const char c)
+{
+    if(log_host_enabled)
+    {
+        fputc(c, stderr);
+    }
+}
+
+void log_puts(const char* str)
+{
+    if(log_host_enabled)
+    {
+        fputs(str, stderr);
+    }
+}
+
+void log_puts_P(const char* str)
+{
+    log_puts(str);
+}
+
+void log_put_uint8_hex(uint8_t val)
+{
+    if(log_host_enabled)
+    {
+        fprintf(stderr, "%02X", val);
+    }
+}
+
+void log_put_uint16_hex(uint16_t val)
+{
+    if(log_host_enabled)
+    {
+        fprintf(stderr, "%04X", val);
+    }
+}
+
+void log_put_uint32_hex(uint32_t val)
+{
+    if(log_host_enabled)
+    {
+        fprintf(stderr, "%08X", val);
+    }
+}
+
+void log_put_uint8(uint8_t val)
+{
+    if(log_host_enabled)
+    {
+        fprintf(stderr, "%u", val);
+    }
+}
+
+void log_put_uint16(uint16_t val)
+{
+    if(log_host_enabled)
+    {
+        fprintf(stderr, "%u", val);
+    }
+}
+
+void log_put_int8(int8_t val)
+{
+    if(log_host_enabled)
+    {
+        fprintf(stderr, "%d", val);
+    }
+}
+
+void log_put_int16(int8_t val)
+{
+    if(log_host_enabled)
+    {
+        fprintf(stderr, "%d", val);
+    }
+}
+
+void log_put_ascii(uint8_t val)
+{
+    if(log_host_enabled)
+    {
+        fputc(val >= 0x20 && val < 0x7F ? val : '.', stderr);
+    }
+}
@@ -0,0 +1,455 @@
+// Builds an SD card image from a directory of songs, with every file stored
+// in one run of clusters and the files ordered the way the controller reads
+// them: the menus and the directory index first, then the songs game by game.
+//
+// The songs are the BIN files in the directory. With a track list, in the
+// format read by make_library, the games, their titles and the order of the
+// tracks come from the list. Without one, NAMEnn.BIN is track nn of the game
+// NAME.
+//
+// The image gets LIBRARY.MNU with the menus of every game, CAT.MNU if the
+// songs fit in it, and DIRINDEX.IDX. Finally the read cost of each file on
+// the controller is reported, which can also be done for any other card
+// image to see how fragmented it is.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "fat32_image.h"
+#include "fat32_builder.h"
+#include "library.h"
+
+// Cost of reading from the card, in SPI bytes, as done by lib/sd.c: sending
+// a command and waiting for the response and the data token, and reading a
+// sector with its CRC
+const int command_bytes = 16;
+const int sector_bytes = Fat32Image::BYTES_PER_SECTOR + 2;
+
+// Extents that the controller keeps for the open file, MAX_EXTENTS in lib/fat32.c
+const size_t max_extents = 8;
+
+// Size of a CAT.MNU record: title, base name, track count and new line
+const int cat_title_len = 20;
+const int cat_record_len = cat_title_len + 6 + 3 + 1;
+
+void print_usage(char *p)
+{
+    fprintf(stderr, "Usage: %s [options] song_dir image\n"
+            "       %s -r image\n"
+            "Options:\n"
+            "  -l file   Track list with the games and titles, see make_library\n"
+            "  -s size   Size of the image in MB (default: as small as possible)\n"
+            "  -c n      Sectors per cluster (default: 8)\n"
+            "  -r        Only report the read cost of the files on an existing image\n",
+            p, p);
+}
+
+static std::vector<uint8_t> read_file(const std::string& filename)
+{
+    std::vector<uint8_t> data;
+
+    FILE *f = fopen(filename.c_str(), "rb");
+    if(!f)
+    {
+        fprintf(stderr, "Error: Could not open file %s\n", filename.c_str());
+        exit(1);
+    }
+
+    uint8_t buf[4096];
+    size_t n;
+
+    while((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    {
+        data.insert(data.end(), buf, buf + n);
+    }
+
+    fclose(f);
+    return data;
+}
+
+// Song files in the directory by upper case base name
+static std::map<std::string, std::string> list_songs(const std::string& dirname)
+{
+    std::map<std::string, std::string> songs;
+
+    DIR *dir = opendir(dirname.c_str());
+    if(!dir)
+    {
+        fprintf(stderr, "Error: Could not open directory %s\n", dirname.c_str());
+        exit(1);
+    }
+
+    struct dirent *ent;
+    while((ent = readdir(dir)))
+    {
+        std::string name = ent->d_name;
+        size_t dot = name.rfind('.');
+
+        if(dot == std::string::npos || strcasecmp(name.c_str() + dot, ".BIN"))
+        {
+            continue;
+        }
+
+        std::string base = name.substr(0, dot);
+        if(base.empty() || base.size() > 8)
+        {
+            fprintf(stderr, "Warning: Skipping %s, which is not an 8.3 name\n", name.c_str());
+            continue;
+        }
+
+        std::transform(base.begin(), base.end(), base.begin(), ::toupper);
+        songs[base] = dirname + "/" + name;
+    }
+
+    closedir(dir);
+    return songs;
+}
+
+static void read_track_list(const std::string& filename, std::vector<Library::Game>& games)
+{
+    FILE *in = fopen(filename.c_str(), "r");
+    if(!in)
+    {
+        fprintf(stderr, "Error: Could not open file %s\n", filename.c_str());
+        exit(1);
+    }
+
+    char buf[256];
+
+    while(fgets(buf, sizeof(buf), in))
+    {
+        std::string line(buf);
+
+        while(!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+        {
+            line.pop_back();
+        }
+
+        if(line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        size_t tab1 = line.find('\t');
+        if(tab1 == std::string::npos)
+        {
+            fprintf(stderr, "Error: Expected game, file name and track title in '%s'\n", line.c_str());
+            exit(1);
+        }
+
+        size_t tab2 = line.find('\t', tab1 + 1);
+
+        Library::Track track;
+        track.filename = line.substr(tab1 + 1, tab2 == std::string::npos ? std::string::npos : tab2 - tab1 - 1);
+        track.title = tab2 == std::string::npos ? "" : line.substr(tab2 + 1);
+        std::transform(track.filename.begin(), track.filename.end(), track.filename.begin(), ::toupper);
+
+        std::string title = line.substr(0, tab1);
+
+        if(games.empty() || games.back().title != title)
+        {
+            games.push_back(Library::Game());
+            games.back().title = title;
+        }
+        games.back().tracks.push_back(track);
+    }
+
+    fclose(in);
+}
+
+// NAMEnn is track nn of NAME, anything else is a game with a single track
+static void group_songs(const std::map<std::string, std::string>& songs, std::vector<Library::Game>& games)
+{
+    std::map<std::string, std::vector<std::pair<int, std::string>>> by_base;
+
+    for(const auto& song : songs)
+    {
+        const std::string& name = song.first;
+
+        if(name.size() > 2 && isdigit((unsigned char)name[name.size() - 2]) && isdigit((unsigned char)name[name.size() - 1]))
+        {
+            by_base[name.substr(0, name.size() - 2)].push_back(std::make_pair(atoi(name.c_str() + name.size() - 2), name));
+        } else {
+            by_base[name].push_back(std::make_pair(0, name));
+        }
+    }
+
+    for(auto& base : by_base)
+    {
+        std::sort(base.second.begin(), base.second.end());
+
+        Library::Game game;
+        game.title = base.first;
+
+        for(const auto& t : base.second)
+        {
+            Library::Track track;
+            track.filename = t.second;
+            game.tracks.push_back(track);
+        }
+
+        games.push_back(game);
+    }
+}
+
+// CAT.MNU can only describe games with a 6 character base name and tracks
+// numbered from 01 to at most 99
+static bool make_cat_menu(const std::vector<Library::Game>& games, std::vector<uint8_t>& data)
+{
+    if(games.empty() || games.size() > 99)
+    {
+        return false;
+    }
+
+    char buf[cat_record_len + 1];
+
+    snprintf(buf, sizeof(buf), "%02lu/%02d\n", (unsigned long)games.size(), cat_record_len);
+    data.assign(buf, buf + strlen(buf));
+
+    for(const Library::Game& game : games)
+    {
+        if(game.tracks.size() > 99)
+        {
+            return false;
+        }
+
+        std::string base = game.tracks[0].filename.substr(0, 6);
+
+        for(size_t i = 0; i < game.tracks.size(); i++)
+        {
+            snprintf(buf, sizeof(buf), "%s%02lu", base.c_str(), (unsigned long)i + 1);
+            if(base.size() != 6 || game.tracks[i].filename != buf)
+            {
+                return false;
+            }
+        }
+
+        snprintf(buf, sizeof(buf), "%-*.*s%s %02lu\n", cat_title_len, cat_title_len, game.title.c_str(),
+                 base.c_str(), (unsigned long)game.tracks.size());
+        data.insert(data.end(), buf, buf + cat_record_len);
+    }
+
+    return true;
+}
+
+// What the controller does to read the whole file: map it into extents,
+// which reads each FAT sector of the chain once, and stream each run of
+// clusters with one READ_MULTIPLE_BLOCK. Past max_extents runs it reads the
+// FAT at every cluster boundary, which also restarts the stream.
+static void report(const std::string& filename)
+{
+    Fat32Image image(filename);
+
+    std::vector<Fat32Image::Entry> dir = image.root_dir();
+
+    printf("%-12s %9s %8s %9s %5s %8s %10s %9s\n",
+           "File", "Size", "Clusters", "Fragments", "FAT", "Commands", "SPI bytes", "Overhead");
+
+    unsigned long fragmented = 0;
+    unsigned long num_files = 0;
+    unsigned long long total_size = 0;
+    unsigned long long total_bytes = 0;
+
+    for(const Fat32Image::Entry& entry : dir)
+    {
+        if(!entry.is_file() || !entry.size)
+        {
+            continue;
+        }
+
+        std::vector<uint32_t> chain = image.cluster_chain(entry.cluster);
+
+        unsigned long fragments = 0;
+        unsigned long fat_sectors = 0;
+        unsigned long commands = 0;
+        uint32_t last_fat_sector = 0;
+
+        for(size_t i = 0; i < chain.size(); i++)
+        {
+            bool new_fragment = i == 0 || chain[i] != chain[i - 1] + 1;
+
+            if(new_fragment)
+            {
+                fragments++;
+            }
+
+            if(fragments <= max_extents)
+            {
+                if(fat_sectors == 0 || image.fat_sector(chain[i]) != last_fat_sector || (i > 0 && chain[i] < chain[i - 1]))
+                {
+                    fat_sectors++;
+                    commands++;
+                    last_fat_sector = image.fat_sector(chain[i]);
+                }
+                if(new_fragment)
+                {
+                    commands++;
+                }
+            } else {
+                // One FAT read and a new stream per cluster
+                fat_sectors++;
+                commands += 2;
+            }
+        }
+
+        unsigned long sectors = (entry.size + Fat32Image::BYTES_PER_SECTOR - 1) / Fat32Image::BYTES_PER_SECTOR;
+        unsigned long long bytes = (unsigned long long)commands * command_bytes + (unsigned long long)(sectors + fat_sectors) * sector_bytes;
+
+        printf("%-12s %9u %8lu %9lu %5lu %8lu %10llu %8.1f%%\n",
+               entry.filename().c_str(), entry.size, (unsigned long)chain.size(), fragments, fat_sectors, commands,
+               bytes, 100.0 * ((double)bytes / entry.size - 1));
+
+        num_files++;
+        fragmented += fragments > 1;
+        total_size += entry.size;
+        total_bytes += bytes;
+    }
+
+    if(num_files)
+    {
+        printf("\n%lu files, %lu fragmented, %.1f%% read overhead in total\n",
+               num_files, fragmented, 100.0 * ((double)total_bytes / total_size - 1));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string track_list;
+    uint32_t size_mb = 0;
+    uint32_t sectors_per_cluster = 8;
+    bool report_only = false;
+
+    int c;
+    while((c = getopt(argc, argv, "l:s:c:r")) != -1)
+    {
+        switch(c)
+        {
+        case 'l':
+            track_list = optarg;
+            break;
+
+        case 's':
+            size_mb = atoi(optarg);
+            break;
+
+        case 'c':
+            sectors_per_cluster = atoi(optarg);
+            if(sectors_per_cluster < 1 || sectors_per_cluster > 128 || (sectors_per_cluster & (sectors_per_cluster - 1)))
+            {
+                fprintf(stderr, "Error: Sectors per cluster must be a power of two up to 128\n");
+                exit(1);
+            }
+            break;
+
+        case 'r':
+            report_only = true;
+            break;
+
+        default:
+            print_usage(argv[0]);
+            exit(1);
+        }
+    }
+
+    if(report_only)
+    {
+        if(optind + 1 != argc)
+        {
+            print_usage(argv[0]);
+            exit(1);
+        }
+
+        report(argv[optind]);
+        return 0;
+    }
+
+    if(optind + 2 != argc)
+    {
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    std::string song_dir = argv[optind];
+    std::string image_name = argv[optind + 1];
+
+    std::map<std::string, std::string> songs = list_songs(song_dir);
+    std::vector<Library::Game> games;
+
+    if(!track_list.empty())
+    {
+        read_track_list(track_list, games);
+    } else {
+        group_songs(songs, games);
+    }
+
+    // The library sorts the games, use the same order on the card
+    Library library;
+
+    for(const Library::Game& game : games)
+    {
+        for(const Library::Track& track : game.tracks)
+        {
+            if(!songs.count(track.filename))
+            {
+                fprintf(stderr, "Error: There is no %s.BIN in %s\n", track.filename.c_str(), song_dir.c_str());
+                exit(1);
+            }
+
+            library.add_track(game.title, track.filename, track.title);
+        }
+    }
+
+    games = library.sorted_games();
+
+    Fat32Builder builder(sectors_per_cluster);
+
+    size_t num_files = 3;
+    for(const Library::Game& game : games)
+    {
+        num_files += game.tracks.size();
+    }
+
+    // Filled in once the clusters of the files are known
+    builder.add_file("DIRINDEX", "IDX", std::vector<uint8_t>(Fat32Image::INDEX_HEADER_SIZE + num_files * Fat32Image::INDEX_ENTRY_SIZE));
+
+    builder.add_file("LIBRARY", "MNU", library.build());
+
+    std::vector<uint8_t> cat;
+    if(make_cat_menu(games, cat))
+    {
+        builder.add_file("CAT", "MNU", cat);
+    } else {
+        printf("The songs don't fit in CAT.MNU, only LIBRARY.MNU is written\n");
+    }
+
+    for(const Library::Game& game : games)
+    {
+        for(const Library::Track& track : game.tracks)
+        {
+            builder.add_file(track.filename, "BIN", read_file(songs[track.filename]));
+        }
+    }
+
+    builder.write(image_name, size_mb);
+
+    {
+        Fat32Image image(image_name, true);
+        image.write_dir_index();
+    }
+
+    printf("Wrote %lu games with %lu tracks to %s\n\n",
+           (unsigned long)library.num_games(), (unsigned long)library.num_tracks(), image_name.c_str());
+
+    report(image_name);
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Writes LIBRARY.MNU, the song library that the controller browses by
+// letter, game and track, from a list of tracks.
+//
+// Each line of the list is a track: the title of the game, the song file
+// name without extension and optionally the title of the track, separated
+// by tabs. Lines starting with '#' are ignored.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "library.h"
+
+void print_usage(char *p)
+{
+    fprintf(stderr, "Usage: %s tracks.txt LIBRARY.MNU\n", p);
+}
+
+static std::vector<std::string> split_tabs(const std::string& line)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+
+    for(;;)
+    {
+        size_t end = line.find('\t', start);
+        fields.push_back(line.substr(start, end == std::string::npos ? std::string::npos : end - start));
+
+        if(end == std::string::npos)
+        {
+            break;
+        }
+        start = end + 1;
+    }
+
+    return fields;
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc != 3)
+    {
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    FILE *in = fopen(argv[1], "r");
+    if(!in)
+    {
+        fprintf(stderr, "Error: Could not open file %s\n", argv[1]);
+        exit(1);
+    }
+
+    Library library;
+    char buf[256];
+    unsigned line_num = 0;
+
+    while(fgets(buf, sizeof(buf), in))
+    {
+        std::string line(buf);
+        line_num++;
+
+        while(!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+        {
+            line.pop_back();
+        }
+
+        if(line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        std::vector<std::string> fields = split_tabs(line);
+
+        if(fields.size() < 2 || fields.size() > 3)
+        {
+            fprintf(stderr, "Error: Expected game, file name and track title on line %u\n", line_num);
+            exit(1);
+        }
+
+        library.add_track(fields[0], fields[1], fields.size() > 2 ? fields[2] : "");
+    }
+
+    fclose(in);
+
+    std::vector<uint8_t> data = library.build();
+
+    FILE *out = fopen(argv[2], "wb");
+    if(!out || fwrite(&data[0], data.size(), 1, out) != 1)
+    {
+        fprintf(stderr, "Error: Could not write file %s\n", argv[2]);
+        exit(1);
+    }
+    fclose(out);
+
+    printf("Wrote %lu games with %lu tracks, %lu bytes\n",
+           (unsigned long)library.num_games(), (unsigned long)library.num_tracks(), (unsigned long)data.size());
+
+    return 0;
+}
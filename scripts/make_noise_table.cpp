@@ -0,0 +1,77 @@
+// Writes channel/noise_table.c: the output of the noise channel's shift
+// register in both modes, for the channel to play back instead of clocking
+// the register in its sample interrupt.
+//
+// The bits are packed seven to a byte, first bit in bit 0, with bit 7 set
+// as a sentinel: the interrupt shifts a byte right once per sample and loads
+// the next one when only zero is left. A set bit means a silent sample. A
+// zero byte ends each table. The long sequence of 32767 bits is exactly 4681
+// bytes, and the short sequence of 93 bits is repeated seven times to fill
+// 93 bytes, so both loop without a seam.
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <vector>
+
+// Bit 0 of the register after each clock, starting from 1 as on power up
+static std::vector<int> noise_sequence(bool short_mode)
+{
+    std::vector<int> bits;
+    uint16_t shift_register = 1;
+
+    do
+    {
+        int feedback = (shift_register & 0x01) ^ ((shift_register >> (short_mode ? 6 : 1)) & 0x01);
+
+        shift_register = (shift_register >> 1) | (feedback << 14);
+        bits.push_back(shift_register & 0x01);
+    } while(shift_register != 1);
+
+    return bits;
+}
+
+static void print_table(const char *name, const std::vector<int>& sequence)
+{
+    std::vector<int> bits;
+
+    while(bits.empty() || bits.size() % 7)
+    {
+        bits.insert(bits.end(), sequence.begin(), sequence.end());
+    }
+
+    printf("\nconst uint8_t %s[%lu] PROGMEM = {", name, (unsigned long)bits.size() / 7 + 1);
+
+    for(size_t i = 0; i < bits.size(); i += 7)
+    {
+        uint8_t b = 0x80;
+
+        for(int j = 0; j < 7; j++)
+        {
+            b |= bits[i + j] << j;
+        }
+
+        printf("%s0x%02X,", (i / 7) % 16 ? " " : "\n    ", b);
+    }
+
+    printf("\n    0x00\n};\n");
+}
+
+int main()
+{
+    std::vector<int> long_sequence = noise_sequence(false);
+    std::vector<int> short_sequence = noise_sequence(true);
+
+    fprintf(stderr, "Long sequence: %lu bits, short sequence: %lu bits\n",
+            (unsigned long)long_sequence.size(), (unsigned long)short_sequence.size());
+
+    printf("// Generated by scripts/make_noise_table\n\n");
+    printf("#include <avr/io.h>\n");
+    printf("#include <avr/pgmspace.h>\n");
+    printf("\n#include \"noise_table.h\"\n");
+
+    print_table("noise_table_long", long_sequence);
+    print_table("noise_table_short", short_sequence);
+
+    return 0;
+}
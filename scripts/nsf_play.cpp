@@ -177,7 +177,7 @@ int main(int argc, char **argv)
 
         int prev_time = 0;
         const int frame_time_const = 29830;
-        for(r : emu->apu_()->reg_writes)
+        for(const RegWrite& r : emu->apu_()->reg_writes)
         {
             if(r.time - prev_time >= 10000) // try to sync with frames in the audio
             {
@@ -0,0 +1,421 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <chrono>
+
+#include "output_sink.h"
+#include "Wave_Writer.h"
+
+#ifdef ALSA
+#include <alsa/asoundlib.h>
+#endif
+
+
+/// WAV //////////////////////////////////////////////////////////////////////////////////////
+
+WaveSink::WaveSink(long sample_rate, const std::string& filename)
+{
+    wave = new Wave_Writer(sample_rate, filename.c_str());
+    wave->enable_stereo();
+}
+
+WaveSink::~WaveSink()
+{
+    delete wave;
+}
+
+void WaveSink::write(const blip_sample_t *buf, size_t count)
+{
+    wave->write(buf, count);
+}
+
+
+/// Raw PCM //////////////////////////////////////////////////////////////////////////////////
+
+RawSink::RawSink(const std::string& filename)
+{
+    file = fopen(filename.c_str(), "wb");
+    if(!file)
+    {
+        fprintf(stderr, "Error: Could not open file %s\n", filename.c_str());
+        exit(1);
+    }
+}
+
+RawSink::~RawSink()
+{
+    fclose(file);
+}
+
+void RawSink::write(const blip_sample_t *buf, size_t count)
+{
+    unsigned char bytes[4096];
+
+    while(count)
+    {
+        size_t n = count < sizeof(bytes) / 2 ? count : sizeof(bytes) / 2;
+
+        // convert to lsb first format
+        for(size_t i = 0; i < n; i++)
+        {
+            bytes[2*i + 0] = buf[i] & 0xFF;
+            bytes[2*i + 1] = (buf[i] >> 8) & 0xFF;
+        }
+
+        if(fwrite(bytes, 2, n, file) != n)
+        {
+            fprintf(stderr, "Error: Could not write raw PCM data\n");
+            exit(1);
+        }
+
+        buf += n;
+        count -= n;
+    }
+}
+
+
+/// ALSA /////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef ALSA
+
+AlsaSink::AlsaSink(const std::string& device, unsigned int& sample_rate, size_t buffer_size, bool use_mmap)
+    : use_mmap(use_mmap), xruns(0)
+{
+    int pcm_error;
+    unsigned tmp;
+
+    /* Open the PCM device in playback mode */
+    pcm_error = snd_pcm_open(&pcm_handle, device.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
+    if (pcm_error < 0)
+    {
+        printf("ERROR: Can't open \"%s\" PCM device. %s\n", device.c_str(), snd_strerror(pcm_error));
+        exit(1);
+    }
+
+    snd_pcm_hw_params_t *params;
+
+    /* Allocate parameters object and fill it with default values*/
+
+    snd_pcm_hw_params_alloca(&params);
+
+    snd_pcm_hw_params_any(pcm_handle, params);
+
+    /* Set parameters */
+    pcm_error = snd_pcm_hw_params_set_access(pcm_handle, params,
+                                             use_mmap ? SND_PCM_ACCESS_MMAP_INTERLEAVED : SND_PCM_ACCESS_RW_INTERLEAVED);
+    if (pcm_error < 0)
+    {
+        printf("ERROR: Can't set interleaved mode. %s\n", snd_strerror(pcm_error));
+        exit(1);
+    }
+
+    pcm_error = snd_pcm_hw_params_set_format(pcm_handle, params, SND_PCM_FORMAT_S16_LE);
+    if (pcm_error < 0)
+    {
+        printf("ERROR: Can't set format. %s\n", snd_strerror(pcm_error));
+        exit(1);
+    }
+
+    pcm_error = snd_pcm_hw_params_set_channels(pcm_handle, params, 2);
+    if (pcm_error < 0)
+    {
+        printf("ERROR: Can't set channels number. %s\n", snd_strerror(pcm_error));
+        exit(1);
+    }
+
+    pcm_error = snd_pcm_hw_params_set_rate_near(pcm_handle, params, &sample_rate, 0);
+    if (pcm_error < 0)
+    {
+        printf("ERROR: Can't set rate. %s\n", snd_strerror(pcm_error));
+        exit(1);
+    }
+
+    pcm_error = snd_pcm_hw_params_set_buffer_size(pcm_handle, params, buffer_size);
+    if (pcm_error < 0)
+    {
+        printf("ERROR: Can't set buffer size. %s\n", snd_strerror(pcm_error));
+        exit(1);
+    }
+
+
+    /* Write parameters */
+    pcm_error = snd_pcm_hw_params(pcm_handle, params);
+    if (pcm_error < 0)
+    {
+        printf("ERROR: Can't set harware parameters. %s\n", snd_strerror(pcm_error));
+        exit(1);
+    }
+
+    /* Resume information */
+    printf("PCM name: '%s'\n", snd_pcm_name(pcm_handle));
+    printf("PCM state: %s\n", snd_pcm_state_name(snd_pcm_state(pcm_handle)));
+
+    snd_pcm_uframes_t f;
+    snd_pcm_hw_params_get_buffer_size(params, &f);
+    printf("PCM buffer size: %lu\n", f);
+
+    snd_pcm_hw_params_get_channels(params, &tmp);
+    printf("Channels: %i ", tmp);
+
+    if (tmp == 1)
+        printf("(mono)\n");
+    else if (tmp == 2)
+        printf("(stereo)\n");
+
+    snd_pcm_hw_params_get_rate(params, &tmp, 0);
+    printf("Rate: %d bps\n", tmp);
+}
+
+AlsaSink::~AlsaSink()
+{
+    snd_pcm_drain(pcm_handle);
+    snd_pcm_close(pcm_handle);
+}
+
+void AlsaSink::recover(int pcm_error)
+{
+    if (pcm_error == -EPIPE) {
+        printf("XRUN.\n");
+        xruns++;
+        snd_pcm_prepare(pcm_handle);
+    } else if (pcm_error < 0) {
+        printf("ERROR. Can't write to PCM device. %s\n", snd_strerror(pcm_error));
+    }
+}
+
+void AlsaSink::write(const blip_sample_t *buf, size_t count)
+{
+    if(use_mmap)
+    {
+        write_mmap(buf, count);
+        return;
+    }
+
+    int pcm_error = snd_pcm_writei(pcm_handle, buf, count/2);
+    if (pcm_error < 0) {
+        recover(pcm_error);
+    }
+}
+
+// Copy the frames directly into the ring buffer of the sound card
+void AlsaSink::write_mmap(const blip_sample_t *buf, size_t count)
+{
+    snd_pcm_uframes_t frames = count / 2;
+
+    while(frames > 0)
+    {
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(pcm_handle);
+        if(avail < 0)
+        {
+            recover(avail);
+            continue;
+        }
+
+        if(avail == 0)
+        {
+            if(snd_pcm_state(pcm_handle) == SND_PCM_STATE_PREPARED)
+            {
+                snd_pcm_start(pcm_handle);
+            }
+            snd_pcm_wait(pcm_handle, 100);
+            continue;
+        }
+
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t n = frames;
+
+        int pcm_error = snd_pcm_mmap_begin(pcm_handle, &areas, &offset, &n);
+        if(pcm_error < 0)
+        {
+            recover(pcm_error);
+            continue;
+        }
+
+        // Interleaved, so both channels share the first area
+        char *dest = (char*)areas[0].addr + (areas[0].first + offset * areas[0].step) / 8;
+        memcpy(dest, buf, n * 2 * sizeof(blip_sample_t));
+
+        snd_pcm_sframes_t committed = snd_pcm_mmap_commit(pcm_handle, offset, n);
+        if(committed < 0 || (snd_pcm_uframes_t)committed != n)
+        {
+            recover(committed < 0 ? committed : -EPIPE);
+            continue;
+        }
+
+        buf += n * 2;
+        frames -= n;
+    }
+
+    if(snd_pcm_state(pcm_handle) == SND_PCM_STATE_PREPARED)
+    {
+        snd_pcm_start(pcm_handle);
+    }
+}
+
+void AlsaSink::print_stats() const
+{
+    printf("ALSA: %lu xruns\n", xruns);
+}
+
+#endif
+
+
+/// Threaded sink ////////////////////////////////////////////////////////////////////////////
+
+ThreadedSink::ThreadedSink(OutputSink *sink, size_t ring_size)
+    : sink(sink), ring(ring_size), done(false),
+      underruns(0), min_fill(ring_size), max_fill(0), sum_fill(0), fill_count(0)
+{
+    thread = std::thread(&ThreadedSink::run, this);
+
+    // Needs CAP_SYS_NICE or an rtprio limit, fall back to normal scheduling otherwise
+    sched_param param;
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param);
+}
+
+ThreadedSink::~ThreadedSink()
+{
+    finish();
+    delete sink;
+}
+
+void ThreadedSink::write(const blip_sample_t *buf, size_t count)
+{
+    while(count)
+    {
+        size_t n = ring.write(buf, count);
+        if(!n)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        buf += n;
+        count -= n;
+    }
+}
+
+void ThreadedSink::finish()
+{
+    if(thread.joinable())
+    {
+        done = true;
+        thread.join();
+        sink->finish();
+    }
+}
+
+void ThreadedSink::run()
+{
+    // Give the renderer a head start before the sink starts pulling samples
+    while(!done && ring.fill() < ring.capacity() / 4)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Set while the ring is short of a stereo frame. An underrun is counted
+    // once the samples come back, so that draining the ring at the end isn't.
+    bool starved = false;
+
+    for(;;)
+    {
+        // Read done first so that nothing written before it was set is missed
+        bool last = done;
+        size_t fill = ring.fill();
+
+        if(fill < 2)
+        {
+            if(last)
+            {
+                break;
+            }
+            starved = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        if(starved)
+        {
+            underruns++;
+            starved = false;
+        }
+
+        if(fill < min_fill) min_fill = fill;
+        if(fill > max_fill) max_fill = fill;
+        sum_fill += fill;
+        fill_count++;
+
+        const blip_sample_t *p;
+        size_t n = ring.peek(&p);
+
+        // Keep to whole stereo frames. The tail only moves by whole frames
+        // and the capacity is even, so a run that ends at the wrap still
+        // holds at least one.
+        n &= ~(size_t)1;
+        sink->write(p, n);
+        ring.consume(n);
+    }
+}
+
+void ThreadedSink::print_stats() const
+{
+    printf("Ring: %lu underruns, fill min %lu avg %lu max %lu of %lu samples\n",
+           underruns, (unsigned long)(fill_count ? min_fill : 0),
+           (unsigned long)(fill_count ? sum_fill / fill_count : 0),
+           (unsigned long)max_fill, (unsigned long)ring.capacity());
+    sink->print_stats();
+}
+
+
+/// Multiple sinks ///////////////////////////////////////////////////////////////////////////
+
+MultiSink::~MultiSink()
+{
+    for(OutputSink *sink : sinks)
+    {
+        delete sink;
+    }
+}
+
+void MultiSink::add(OutputSink *sink)
+{
+    sinks.push_back(sink);
+}
+
+void MultiSink::write(const blip_sample_t *buf, size_t count)
+{
+    for(OutputSink *sink : sinks)
+    {
+        sink->write(buf, count);
+    }
+}
+
+void MultiSink::finish()
+{
+    for(OutputSink *sink : sinks)
+    {
+        sink->finish();
+    }
+}
+
+void MultiSink::print_stats() const
+{
+    for(OutputSink *sink : sinks)
+    {
+        sink->print_stats();
+    }
+}
+
+bool MultiSink::realtime() const
+{
+    for(OutputSink *sink : sinks)
+    {
+        if(sink->realtime())
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,149 @@
+#ifndef OUTPUT_SINK_H_
+#define OUTPUT_SINK_H_
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "gme/Blip_Buffer.h"
+#include "sample_ring.h"
+
+class Wave_Writer;
+
+// Destination for the interleaved stereo samples rendered by bin_play
+
+class OutputSink
+{
+public:
+    virtual ~OutputSink() {}
+
+    virtual void write(const blip_sample_t *buf, size_t count) = 0;
+
+    // True if the sink paces the renderer, i.e. it plays in real time
+    virtual bool realtime() const { return false; }
+
+    // Called once after the last write, before print_stats()
+    virtual void finish() {}
+
+    virtual void print_stats() const {}
+};
+
+class WaveSink : public OutputSink
+{
+public:
+    WaveSink(long sample_rate, const std::string& filename);
+    ~WaveSink();
+
+    void write(const blip_sample_t *buf, size_t count);
+
+private:
+    Wave_Writer *wave;
+};
+
+// Headerless 16-bit little endian PCM
+
+class RawSink : public OutputSink
+{
+public:
+    RawSink(const std::string& filename);
+    ~RawSink();
+
+    void write(const blip_sample_t *buf, size_t count);
+
+private:
+    FILE *file;
+};
+
+// Discards everything, for measuring the speed of the renderer itself
+
+class NullSink : public OutputSink
+{
+public:
+    void write(const blip_sample_t *buf, size_t count) {}
+};
+
+#ifdef ALSA
+
+typedef struct _snd_pcm snd_pcm_t;
+
+// With use_mmap the samples are copied straight into the sound card buffer
+// instead of going through snd_pcm_writei
+
+class AlsaSink : public OutputSink
+{
+public:
+    AlsaSink(const std::string& device, unsigned int& sample_rate, size_t buffer_size, bool use_mmap = false);
+    ~AlsaSink();
+
+    void write(const blip_sample_t *buf, size_t count);
+    bool realtime() const { return true; }
+    void print_stats() const;
+
+private:
+    snd_pcm_t *pcm_handle;
+    bool use_mmap;
+    unsigned long xruns;
+
+    void write_mmap(const blip_sample_t *buf, size_t count);
+    void recover(int pcm_error);
+};
+
+#endif
+
+// Runs another sink on its own thread, fed through a lock-free ring buffer,
+// so that a slow renderer or file I/O on the calling thread doesn't starve
+// it. write() only blocks when the ring is full.
+
+class ThreadedSink : public OutputSink
+{
+public:
+    ThreadedSink(OutputSink *sink, size_t ring_size);
+    ~ThreadedSink();
+
+    void write(const blip_sample_t *buf, size_t count);
+    bool realtime() const { return sink->realtime(); }
+
+    // Waits until the ring has been emptied into the sink and stops the thread
+    void finish();
+    void print_stats() const;
+
+private:
+    OutputSink *sink;
+    SampleRing<blip_sample_t> ring;
+    std::thread thread;
+    std::atomic<bool> done;
+
+    // Only touched by the sink thread until finish() has joined it
+    unsigned long underruns;
+    size_t min_fill;
+    size_t max_fill;
+    double sum_fill;
+    unsigned long fill_count;
+
+    void run();
+};
+
+// Forwards the samples to every sink in the list
+
+class MultiSink : public OutputSink
+{
+public:
+    ~MultiSink();
+
+    void add(OutputSink *sink);
+    bool empty() const { return sinks.empty(); }
+
+    void write(const blip_sample_t *buf, size_t count);
+    bool realtime() const;
+    void finish();
+    void print_stats() const;
+
+private:
+    std::vector<OutputSink*> sinks;
+};
+
+#endif
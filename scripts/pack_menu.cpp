@@ -0,0 +1,111 @@
+// Converts a text menu file for the SD card, such as CAT.MNU, into a menu
+// with fixed length records so that the controller can seek straight to any
+// entry instead of counting lines from the start of the file.
+//
+// The input starts with a line with the number of entries, followed by one
+// line per entry. The output starts with "NN/RR\n", the number of entries and
+// the record length as two digits each, followed by the entries padded with
+// spaces to RR-1 characters and terminated by a new line. The records are at
+// least as long as a line of the display, which the controller fills.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+// SSD1306_LINE_WIDTH in lib/ssd1306.h
+const size_t min_record_len = 21;
+
+void print_usage(char *p)
+{
+    fprintf(stderr, "Usage: %s in.mnu out.mnu\n", p);
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc != 3)
+    {
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    FILE *in = fopen(argv[1], "r");
+    if(!in)
+    {
+        fprintf(stderr, "Error: Could not open file %s\n", argv[1]);
+        exit(1);
+    }
+
+    std::vector<std::string> lines;
+    char buf[256];
+
+    while(fgets(buf, sizeof(buf), in))
+    {
+        std::string line(buf);
+
+        while(!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+        {
+            line.pop_back();
+        }
+
+        lines.push_back(line);
+    }
+
+    fclose(in);
+
+    while(!lines.empty() && lines.back().empty())
+    {
+        lines.pop_back();
+    }
+
+    if(lines.empty())
+    {
+        fprintf(stderr, "Error: %s is empty\n", argv[1]);
+        exit(1);
+    }
+
+    size_t num_entries = lines.size() - 1;
+    size_t record_len = min_record_len;
+
+    if(strtoul(lines[0].c_str(), 0, 10) != num_entries)
+    {
+        fprintf(stderr, "Warning: The header says %s entries but there are %lu\n",
+                lines[0].c_str(), (unsigned long)num_entries);
+    }
+
+    for(size_t i = 1; i < lines.size(); i++)
+    {
+        if(lines[i].size() + 1 > record_len)
+        {
+            record_len = lines[i].size() + 1;
+        }
+    }
+
+    if(num_entries > 99 || record_len > 99)
+    {
+        fprintf(stderr, "Error: At most 99 entries of 98 characters are supported\n");
+        exit(1);
+    }
+
+    FILE *out = fopen(argv[2], "wb");
+    if(!out)
+    {
+        fprintf(stderr, "Error: Could not open file %s\n", argv[2]);
+        exit(1);
+    }
+
+    fprintf(out, "%02lu/%02lu\n", (unsigned long)num_entries, (unsigned long)record_len);
+
+    for(size_t i = 1; i < lines.size(); i++)
+    {
+        fprintf(out, "%-*s\n", (int)record_len - 1, lines[i].c_str());
+    }
+
+    fclose(out);
+
+    printf("Wrote %lu entries of %lu bytes\n", (unsigned long)num_entries, (unsigned long)record_len);
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+#ifndef SAMPLE_RING_H_
+#define SAMPLE_RING_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#include <atomic>
+#include <vector>
+
+// Lock-free ring buffer for one producer thread and one consumer thread.
+// The capacity must be a power of two. head and tail count samples written
+// and read since the start and are only ever advanced by their own thread.
+
+template<class T>
+class SampleRing
+{
+public:
+    SampleRing(size_t capacity) : buf(capacity), mask(capacity - 1), head(0), tail(0) {}
+
+    size_t capacity() const { return buf.size(); }
+
+    // Number of samples waiting to be read
+    size_t fill() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    // Producer: copy as many of the samples as fit, returns the number copied
+    size_t write(const T *src, size_t count)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t space = buf.size() - (h - tail.load(std::memory_order_acquire));
+
+        if(count > space)
+        {
+            count = space;
+        }
+
+        size_t first = buf.size() - (h & mask);
+        if(first > count)
+        {
+            first = count;
+        }
+
+        memcpy(&buf[h & mask], src, first * sizeof(T));
+        memcpy(&buf[0], src + first, (count - first) * sizeof(T));
+
+        head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: contiguous run of samples that can be read in place
+    size_t peek(const T **p) const
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t avail = head.load(std::memory_order_acquire) - t;
+        size_t first = buf.size() - (t & mask);
+
+        *p = &buf[t & mask];
+        return avail < first ? avail : first;
+    }
+
+    // Consumer: release samples returned by peek()
+    void consume(size_t count)
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+private:
+    std::vector<T> buf;
+    const size_t mask;
+
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+};
+
+#endif
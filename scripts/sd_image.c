@@ -0,0 +1,207 @@
+// Host implementation of the SD card driver in lib/sd.c, backed by an image
+// of the card. Every function does the same SPI transfers as the one in
+// lib/sd.c, as far as the count goes, so keep the two in step.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "sd.h"
+#include "sd_image.h"
+
+#define BYTES_PER_SECTOR 512
+
+struct sd_image_stats_t sd_image_stats;
+
+unsigned sd_image_access_bytes = 1;
+unsigned sd_image_response_bytes = 1;
+
+typedef struct
+{
+    FILE *file;
+
+    uint8_t sector[BYTES_PER_SECTOR];
+    uint16_t sector_bytes_left;
+
+    uint8_t streaming;
+    uint32_t stream_sector;
+} sd_image_t;
+
+static sd_image_t sd_image;
+
+
+int sd_image_open(const char *filename)
+{
+    sd_image.file = fopen(filename, "rb");
+    return sd_image.file != NULL;
+}
+
+void sd_image_close()
+{
+    if(sd_image.file)
+    {
+        fclose(sd_image.file);
+        sd_image.file = NULL;
+    }
+}
+
+void sd_image_reset_stats()
+{
+    memset(&sd_image_stats, 0, sizeof(sd_image_stats));
+}
+
+static void spi_bytes(unsigned long n)
+{
+    sd_image_stats.spi_bytes += n;
+}
+
+// Card side of a block read: wait for the data token, then the data
+static void sd_image_load_sector(uint32_t sector)
+{
+    if(fseek(sd_image.file, (long)sector * BYTES_PER_SECTOR, SEEK_SET)
+       || fread(sd_image.sector, BYTES_PER_SECTOR, 1, sd_image.file) != 1)
+    {
+        fprintf(stderr, "Error: Could not read sector %u of the image\n", sector);
+        exit(1);
+    }
+
+    spi_bytes(sd_image_access_bytes);
+    sd_image_stats.sectors++;
+
+    sd_image.sector_bytes_left = BYTES_PER_SECTOR;
+}
+
+static void sd_send_command(uint8_t cmd)
+{
+    spi_bytes(6);
+
+    sd_image_stats.commands++;
+    sd_image_stats.command_count[cmd & 0x3F]++;
+}
+
+uint8_t sd_command(uint8_t cmd, uint32_t arg, uint8_t crc)
+{
+    sd_send_command(cmd);
+    spi_bytes(sd_image_response_bytes);
+
+    return 0;
+}
+
+uint8_t sd_sector_done()
+{
+    return sd_image.sector_bytes_left == 0;
+}
+
+void sd_begin_sector(uint32_t sector)
+{
+    if(sd_image.streaming)
+    {
+        sd_end_sector();
+    }
+
+    sd_command(17, sector, 0xFF);
+    sd_image_load_sector(sector);
+}
+
+void sd_stream_sector(uint32_t sector)
+{
+    if(sd_image.streaming && sd_image.stream_sector == sector && !sd_image.sector_bytes_left)
+    {
+        // CRC
+        spi_bytes(2);
+    } else {
+        sd_end_sector();
+        sd_command(18, sector, 0xFF);
+        sd_image.streaming = 1;
+    }
+
+    sd_image_load_sector(sector);
+    sd_image.stream_sector = sector + 1;
+}
+
+static void sd_stop_stream()
+{
+    // Command, stuff byte, response and the end of busy
+    sd_send_command(12);
+    spi_bytes(1 + sd_image_response_bytes + 1);
+
+    sd_image.streaming = 0;
+    sd_image.sector_bytes_left = 0;
+}
+
+void sd_end_sector()
+{
+    if(sd_image.streaming)
+    {
+        sd_stop_stream();
+    } else {
+        sd_read_block(NULL, sd_image.sector_bytes_left);
+
+        // CRC
+        spi_bytes(2);
+    }
+}
+
+uint16_t sd_read_block(uint8_t *buf, uint16_t len)
+{
+    if(len > sd_image.sector_bytes_left)
+    {
+        len = sd_image.sector_bytes_left;
+    }
+
+    if(buf)
+    {
+        memcpy(buf, &sd_image.sector[BYTES_PER_SECTOR - sd_image.sector_bytes_left], len);
+    }
+
+    sd_image.sector_bytes_left -= len;
+    spi_bytes(len);
+
+    return len;
+}
+
+uint32_t sd_read_uint32()
+{
+    uint8_t buf[4];
+    sd_read_block(buf, 4);
+    return ((uint32_t)buf[3] << 24) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[1] << 8) | buf[0];
+}
+
+uint16_t sd_read_uint16()
+{
+    uint8_t buf[2];
+    sd_read_block(buf, 2);
+    return (buf[1] << 8) | buf[0];
+}
+
+uint8_t sd_read_uint8()
+{
+    uint8_t byte;
+    sd_read_block(&byte, 1);
+    return byte;
+}
+
+void sd_skip_bytes(uint16_t bytes)
+{
+    sd_read_block(NULL, bytes);
+}
+
+void sd_debug_print_16_bytes()
+{
+}
+
+void sd_init()
+{
+    // 80 idle clocks, GO_IDLE_STATE, SEND_IF_COND with its 4 byte answer and
+    // one round of APP_CMD and SD_SEND_OP_COND
+    spi_bytes(10);
+    sd_command(0, 0x00000000, 0x95);
+    sd_command(8, 0x000001AA, 0x87);
+    spi_bytes(4);
+    sd_command(55, 0x00000000, 0xFF);
+    sd_command(41, 0x40000000, 0xFF);
+
+    sd_image.sector_bytes_left = 0;
+    sd_image.streaming = 0;
+}
@@ -0,0 +1,41 @@
+#ifndef SD_IMAGE_H_
+#define SD_IMAGE_H_
+
+// Host implementation of lib/sd.h reading from an SD card image instead of
+// the card, so that lib/fat32.c can be run and measured on the host. It
+// counts the SPI bytes that lib/sd.c would transfer for the same calls.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+struct sd_image_stats_t
+{
+    unsigned long spi_bytes;
+    unsigned long commands;
+    unsigned long sectors;        // Data blocks received from the card
+    unsigned long command_count[64];
+};
+
+extern struct sd_image_stats_t sd_image_stats;
+
+// Bytes clocked while waiting for the data token of a block, 1 for a card
+// that answers at once. Real cards take anything from a few bytes to
+// hundreds, so measure a card before trusting absolute numbers.
+extern unsigned sd_image_access_bytes;
+
+// Bytes clocked while waiting for the response to a command
+extern unsigned sd_image_response_bytes;
+
+int sd_image_open(const char *filename);
+void sd_image_close();
+
+void sd_image_reset_stats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
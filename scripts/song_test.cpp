@@ -0,0 +1,168 @@
+// Round trips songs larger than 64 KiB, with a LOOP_BYTE_LONG record whose
+// destination has END_FRAME or END_SONG as an address byte, through
+// DatFile and through song_read_chunk() of the controller. fat32_read()
+// and fat32_seek() read the saved song from memory.
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dat_file.h"
+
+extern "C" {
+#include "fat32.h"
+#include "song.h"
+}
+
+static std::string song_data;
+static uint32_t song_pos;
+
+uint16_t fat32_read(void *raw_buf, uint16_t len)
+{
+    uint8_t *buf = (uint8_t*)raw_buf;
+    uint16_t n = 0;
+
+    while(n < len && song_pos < song_data.size())
+    {
+        buf[n++] = song_data[song_pos++];
+    }
+
+    return n;
+}
+
+void fat32_seek(uint32_t len)
+{
+    song_pos = len;
+}
+
+static unsigned failures;
+
+static void check(bool ok, const char *what, uint32_t dest)
+{
+    if(!ok)
+    {
+        printf("FAIL: %s, loop to 0x%08X\n", what, dest);
+        failures++;
+    }
+}
+
+// Frames of one write each, 4 bytes in the file, past the one at dest and
+// past 64 KiB, and a loop back to dest
+static DatFile make_song(uint32_t dest)
+{
+    DatFile song;
+
+    for(uint32_t offset = 0; offset < dest + 0x100 || offset < 0x14000; offset += 4)
+    {
+        Frame frame;
+        frame.regs.push_back(Reg((offset / 4) % 0x18, (offset / 4) & 0xFF));
+        song.frames.push_back(frame);
+    }
+
+    song.frames.push_back(loop_byte_frame(dest));
+
+    return song;
+}
+
+static std::vector<Reg> pushed;
+static std::vector<uint32_t> looped;
+
+static void push(uint8_t address, uint8_t value)
+{
+    pushed.push_back(Reg(address, value));
+}
+
+static void loop(uint32_t dest)
+{
+    looped.push_back(dest);
+}
+
+static void test_dat_file(uint32_t dest)
+{
+    DatFile song = make_song(dest);
+
+    std::stringstream bin;
+    song.save_binary(bin);
+
+    DatFile loaded;
+    loaded.load_binary(bin);
+
+    check(loaded.frames == song.frames, "load_binary", dest);
+    check(!loaded.frames.empty() && is_loop_byte_frame(loaded.frames.back()) &&
+          loop_byte_dest(loaded.frames.back()) == dest, "loop_byte_dest after load_binary", dest);
+
+    std::stringstream ascii;
+    song.save_ascii(ascii);
+
+    loaded.clear();
+    loaded.load_ascii(ascii);
+
+    check(loaded.frames == song.frames, "load_ascii", dest);
+}
+
+// Reads the song up to the loop with chunks of max_records records, so that
+// the destination lands at every place in a chunk, and a few records past it
+static void test_song_read_chunk(uint32_t dest, uint8_t max_records)
+{
+    DatFile song = make_song(dest);
+
+    std::stringstream bin;
+    song.save_binary(bin);
+
+    song_data = bin.str();
+    song_pos = 0;
+    pushed.clear();
+    looped.clear();
+
+    while(looped.empty() && song_read_chunk(max_records, push, loop))
+        ;
+
+    const uint32_t loop_offset = song_data.size() - 2 * (song.frames.back().regs.size() + 2);
+
+    check(looped.size() == 1 && looped[0] == dest, "song_read_chunk loop", dest);
+    check(pushed.size() == loop_offset / 2, "song_read_chunk records before the loop", dest);
+
+    bool same = true;
+
+    for(uint32_t i = 0; i < pushed.size() && i < loop_offset / 2; i++)
+    {
+        same = same && pushed[i] == Reg((uint8_t)song_data[2*i], (uint8_t)song_data[2*i+1]);
+    }
+    check(same, "song_read_chunk records", dest);
+
+    // The next chunk starts at the destination
+    pushed.clear();
+    song_read_chunk(4, push, loop);
+
+    check(pushed.size() == 4 && pushed[0] == Reg((uint8_t)song_data[dest], (uint8_t)song_data[dest+1]),
+          "song_read_chunk after the loop", dest);
+}
+
+int main()
+{
+    // The address of the second destination record is END_FRAME, END_SONG
+    // or LOOP_BYTE_LONG, and in the last one a plain 0x00
+    const uint32_t dests[] = { 0x0001F100, 0x0001FF04, 0x0001FC08, 0x00010000 };
+
+    for(uint32_t dest : dests)
+    {
+        test_dat_file(dest);
+
+        for(uint8_t max_records = 1; max_records <= SONG_READ_CHUNK / 2; max_records++)
+        {
+            test_song_read_chunk(dest, max_records);
+        }
+    }
+
+    if(failures)
+    {
+        printf("%u checks failed\n", failures);
+        return 1;
+    }
+
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,746 @@
+// A virtual NESSynth: the playback of the controller and the channel boards
+// on the bus, run together on the PC against an SD card image, to debug the
+// timing of playback without flashing and listening to the boards.
+//
+// The controller side replays song_play() of controller/main.c, with the
+// FAT32 driver of the controller reading the image through sd_image.c: the
+// main loop topping up song_buf with song_read_data() and following the
+// loops, timer 0 ticking the frame clock at 240 Hz, and timer 2 sending a
+// frame back to back with bus_write(), during which the main loop stalls.
+// The channel side runs channel/nes_apu_channel.c for every board, see
+// channel_sim.h, behind a model of PCINT0_vect and bus_buf: an edge of DCLK
+// is lost when the bus interrupt can't read it before the next edge, and a
+// kept write waits in bus_buf until the main loop of the board gets to it.
+//
+// Everything is an event in cycles of the two crystals, which run at the
+// same frequency, so a song plays many times faster than real time. The
+// times spent in the main loops are estimates, the interrupts are counted
+// from the listings by isr_cycles.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <algorithm>
+
+#include "channel_sim.h"
+#include "bus_timing.h"
+#include "fat32_image.h"
+#include "sd_image.h"
+#include "Wave_Writer.h"
+
+extern "C" {
+#include "sd.h"
+#include "fat32.h"
+#include "bus.h"
+#include "song.h"
+
+extern int log_host_enabled;
+}
+
+static const long sample_rate = 44100;
+
+// The controller and the channels have the same crystal
+const double f_cpu = 14318180;
+
+/// Controller /////////////////////////////////////////////////////////////////////////////////
+
+// As in controller/main.c
+const int song_buf_len = 128;
+const int max_play_seconds = 3 * 60; // MAX_PLAY_TIME
+const int reset_delay_ms = 100;
+
+// A saturated SPI bus at f_osc/2 takes 16 cycles per byte
+const int cycles_per_spi_byte = 16;
+
+// Estimated cycles of song_read_data() per record it pushes
+const int cycles_per_record = 24;
+
+/// Channels ///////////////////////////////////////////////////////////////////////////////////
+
+// PCINT0_vect, as counted by isr_cycles, and the cycles from the start of
+// the interrupt response until it has read the bus
+const int bus_address_isr_cycles = 45;
+const int bus_value_isr_cycles = 37;
+const int bus_read_cycles = 7;
+
+// bus_buf holds 255 bytes, as the head can't move onto the tail
+const unsigned bus_buf_writes = 127;
+
+// Estimated cycles of the main loop of a channel per write_reg() and
+// frame_update(), without the interrupts
+const int channel_write_cycles = 120;
+const int channel_frame_cycles = 300;
+
+// Cycles the main loop of a board takes for work of cycles, with the
+// sample interrupt taking its share
+static uint64_t main_loop_cycles(const ChannelBoard& board, int cycles)
+{
+    return cycles / (1 - std::min(0.9, board.sample_isr_load()));
+}
+
+static const char *board_names[NUM_BOARDS] = { "square1", "square2", "triangle", "noise", "vrc6-pulse1", "vrc6-pulse2" };
+
+struct ChannelStats
+{
+    unsigned long writes;     // Kept and put in bus_buf
+    unsigned long lost_edges; // Read too late by PCINT0
+    unsigned long overflows;  // Writes dropped as bus_buf was full
+    unsigned max_depth;       // Writes in bus_buf
+    double depth_sum;
+    uint64_t max_latency;     // Cycles from the value on the bus to write_reg()
+};
+
+// Work for the main loop of a board, in the order it gets to it
+struct ChannelEvent
+{
+    uint64_t cycle;
+    bool frame;
+    uint8_t address;
+    uint8_t value;
+};
+
+struct Channel
+{
+    Channel(unsigned id) : board(id), queued_writes(0), main_busy(0), isr_busy(0),
+                           address(0), keep(false), lost(false), stats() {}
+
+    ChannelBoard board;
+
+    std::deque<ChannelEvent> queue;
+    unsigned queued_writes;
+    uint64_t main_busy; // When the main loop is done with the queue
+    uint64_t isr_busy;  // When the last bus interrupt returns
+
+    uint8_t address;    // Of the write being received
+    bool keep;          // BUS_DROP_BIT cleared
+    bool lost;
+
+    ChannelStats stats;
+};
+
+// A byte on the bus, latched by a rising (address) or falling (value) DCLK
+struct BusEdge
+{
+    uint64_t cycle;
+    bool address;
+    uint8_t data;
+};
+
+struct SongStats
+{
+    double seconds;
+    unsigned long frames;
+
+    // Controller, as logged by song_play()
+    unsigned min_frames;
+    unsigned long underruns;
+    unsigned long late_frames;
+
+    // How far playback fell behind the frame clock, and how much of each
+    // frame the bus was busy
+    uint64_t max_drift;
+    uint64_t bus_cycles;
+    uint64_t max_bus_cycles;
+
+    unsigned long spi_bytes;
+    uint64_t main_cycles;
+    unsigned long loops;
+};
+
+class VirtualSynth
+{
+public:
+    VirtualSynth(const std::vector<unsigned>& board_ids, int strobe, Wave_Writer *wave);
+
+    bool play(const std::string& name, double seconds);
+
+    SongStats stats;
+    std::vector<Channel> channels;
+
+private:
+    void advance(uint64_t cycle);
+    void bus_edge(const BusEdge& edge);
+    void channel_event(Channel& ch);
+    void frame_clock();
+    void send_frame(uint64_t start);
+    void song_buf_push(uint8_t address, uint8_t value);
+    void main_step();
+    static void song_read_push(uint8_t address, uint8_t value);
+    static void song_read_loop(uint32_t dest);
+    void reset_channels();
+    void flush();
+
+    int phase;
+    Wave_Writer *wave;
+
+    // Channel boards
+    DacMixer mixer;
+    std::vector<int32_t> delta;
+    std::vector<short> out;
+    uint64_t chan_tick;
+    uint64_t span_start;
+
+    // Controller
+    std::deque<std::pair<uint8_t, uint8_t> > song_buf;
+    uint8_t song_frames_in;
+    uint8_t song_frames_out;
+    bool song_done;
+    bool main_done;
+    uint8_t frame_counter;
+
+    uint64_t main_time;
+    bool main_waiting;
+    uint64_t next_tick;
+    uint64_t send_end;
+    uint64_t stop_time;
+    uint64_t max_cycles;
+
+    unsigned long frames_sent;
+    uint64_t first_send_tick;
+
+    std::deque<BusEdge> edges;
+
+    // The synth song_read_chunk() reads for, as it only takes functions
+    static VirtualSynth *reading;
+};
+
+VirtualSynth *VirtualSynth::reading;
+
+VirtualSynth::VirtualSynth(const std::vector<unsigned>& board_ids, int strobe, Wave_Writer *w)
+    : phase(bus_phase_cycles(strobe)), wave(w), mixer(sample_rate), delta(FRAME_CLOCK_TICKS),
+      chan_tick(0), span_start(0), song_frames_in(0), song_frames_out(0), song_done(false),
+      main_done(false), frame_counter(0), main_time(0), main_waiting(false),
+      next_tick(frame_clock_cycles), send_end(0), stop_time(0), max_cycles(0),
+      frames_sent(0), first_send_tick(0)
+{
+    for(unsigned id : board_ids)
+    {
+        channels.push_back(Channel(id));
+    }
+
+    memset(&stats, 0, sizeof(stats));
+    stats.min_frames = 0xFF;
+}
+
+/// Channel boards
+
+// Runs the boards up to cycle, mixing their DACs a frame clock at a time
+void VirtualSynth::advance(uint64_t cycle)
+{
+    const uint64_t tick = cycle / 8;
+
+    while(chan_tick < tick)
+    {
+        const uint64_t span_end = span_start + FRAME_CLOCK_TICKS;
+        const uint64_t to = std::min(tick, span_end);
+
+        for(Channel& ch : channels)
+        {
+            ch.board.run(&delta[chan_tick - span_start], to - chan_tick);
+        }
+
+        chan_tick = to;
+
+        if(chan_tick == span_end)
+        {
+            mixer.mix(delta.data(), FRAME_CLOCK_TICKS, out);
+            std::fill(delta.begin(), delta.end(), 0);
+            span_start = span_end;
+
+            if(out.size() >= (size_t)sample_rate)
+            {
+                flush();
+            }
+        }
+    }
+}
+
+void VirtualSynth::flush()
+{
+    if(wave)
+    {
+        wave->write(out.data(), out.size());
+    }
+    out.clear();
+}
+
+// PCINT0_vect on every board. It can't interrupt the sample interrupt or
+// itself, and has to read the bus before the next edge.
+void VirtualSynth::bus_edge(const BusEdge& edge)
+{
+    advance(edge.cycle);
+
+    for(Channel& ch : channels)
+    {
+        const uint64_t start = std::max(edge.cycle + ch.board.sample_isr_left(edge.cycle), ch.isr_busy);
+
+        if(start + bus_read_cycles > edge.cycle + phase)
+        {
+            ch.stats.lost_edges++;
+            ch.lost = true;
+            continue;
+        }
+
+        ch.isr_busy = start + (edge.address ? bus_address_isr_cycles : bus_value_isr_cycles);
+
+        if(edge.address)
+        {
+            ch.address = edge.data;
+            ch.keep = ch.board.keeps(edge.data);
+            ch.lost = false;
+            continue;
+        }
+
+        if(!ch.keep || ch.lost)
+        {
+            continue;
+        }
+
+        if(ch.queued_writes >= bus_buf_writes)
+        {
+            ch.stats.overflows++;
+            continue;
+        }
+
+        // The main loop gets to it after the writes before it, slowed down
+        // by the sample interrupt
+        const uint64_t cycle = std::max(ch.main_busy, ch.isr_busy);
+
+        ch.queue.push_back({ cycle, false, ch.address, edge.data });
+        ch.main_busy = cycle + main_loop_cycles(ch.board, channel_write_cycles);
+        ch.queued_writes++;
+
+        ch.stats.writes++;
+        ch.stats.depth_sum += ch.queued_writes;
+        ch.stats.max_depth = std::max(ch.stats.max_depth, ch.queued_writes);
+        ch.stats.max_latency = std::max(ch.stats.max_latency, cycle - edge.cycle);
+    }
+}
+
+void VirtualSynth::channel_event(Channel& ch)
+{
+    ChannelEvent ev = ch.queue.front();
+    ch.queue.pop_front();
+
+    advance(ev.cycle);
+
+    if(ev.frame)
+    {
+        ch.board.frame_update();
+    } else {
+        ch.board.write_reg(ev.address, ev.value);
+        ch.queued_writes--;
+    }
+}
+
+/// Controller
+
+// TIMER0_COMPA_vect, and the frame clock edge on the boards
+void VirtualSynth::frame_clock()
+{
+    const uint64_t t = next_tick;
+
+    advance(t);
+    next_tick += frame_clock_cycles;
+
+    for(Channel& ch : channels)
+    {
+        const uint64_t cycle = std::max(t, ch.main_busy);
+
+        ch.queue.push_back({ cycle, true, 0, 0 });
+        ch.main_busy = cycle + main_loop_cycles(ch.board, channel_frame_cycles);
+    }
+
+    uint8_t cnt = ++frame_counter;
+
+    if((cnt & 0x03) || song_done)
+    {
+        return;
+    }
+
+    uint8_t frames = song_frames_in - song_frames_out;
+
+    stats.min_frames = std::min<unsigned>(stats.min_frames, frames);
+
+    if(send_end > t)
+    {
+        stats.late_frames++;
+    } else if(!frames) {
+        stats.underruns++;
+    } else {
+        if(!frames_sent)
+        {
+            first_send_tick = t;
+        }
+
+        // Every frame clock that passed without sending a frame delays the
+        // rest of the song
+        const uint64_t due = first_send_tick + frames_sent * FRAME_CLOCK_DIV * frame_clock_cycles;
+        stats.max_drift = std::max(stats.max_drift, t - due);
+
+        frames_sent++;
+
+        send_frame(t + bus_start_cycles);
+
+        stats.bus_cycles += send_end - t;
+        stats.max_bus_cycles = std::max(stats.max_bus_cycles, send_end - t);
+    }
+}
+
+// TIMER2_COMPA_vect: every write in song_buf up to the end of the frame
+void VirtualSynth::send_frame(uint64_t start)
+{
+    uint64_t t = start;
+
+    while(!song_buf.empty())
+    {
+        uint8_t address = song_buf.front().first;
+        uint8_t value = song_buf.front().second;
+        song_buf.pop_front();
+
+        if(address == 0xFF)
+        {
+            song_frames_out++;
+            song_done = true;
+            break;
+        } else if(address == 0xF1) {
+            song_frames_out++;
+            break;
+        }
+
+        edges.push_back({ t, true, address });
+        edges.push_back({ t + phase, false, value });
+        t += 2 * phase;
+    }
+
+    send_end = t;
+
+    // The main loop doesn't run until the interrupt returns
+    if(main_waiting || main_time > start)
+    {
+        main_time = std::max(main_time, start) + (send_end - start);
+    }
+    main_waiting = false;
+}
+
+void VirtualSynth::song_buf_push(uint8_t address, uint8_t value)
+{
+    song_buf.push_back(std::make_pair(address, value));
+}
+
+// song_read_push() and song_read_loop() of controller/main.c
+void VirtualSynth::song_read_push(uint8_t address, uint8_t value)
+{
+    reading->song_buf_push(address, value);
+
+    if(address == 0xF1 || address == 0xFF)
+    {
+        reading->song_frames_in++;
+    }
+}
+
+void VirtualSynth::song_read_loop(uint32_t dest)
+{
+    reading->stats.loops++;
+}
+
+// One chunk of song_read_data(), or waiting for room in song_buf
+void VirtualSynth::main_step()
+{
+    if(song_done || main_time >= max_cycles)
+    {
+        // song_play() stops, and resets the channels
+        song_done = true;
+        reset_channels();
+        return;
+    }
+
+    if(song_buf.size() >= (size_t)song_buf_len)
+    {
+        main_time = next_tick;
+        main_waiting = true;
+        return;
+    }
+
+    const unsigned long spi_start = sd_image_stats.spi_bytes;
+
+    reading = this;
+    const uint8_t len = song_read_chunk(song_buf_len - song_buf.size(), song_read_push, song_read_loop);
+
+    const unsigned long spi_bytes = sd_image_stats.spi_bytes - spi_start;
+    const uint64_t cycles = spi_bytes * cycles_per_spi_byte + len / 2 * cycles_per_record;
+
+    stats.spi_bytes += spi_bytes;
+    stats.main_cycles += cycles;
+
+    if(!len)
+    {
+        // The end of the file, wait for the frames to be sent
+        main_time = next_tick;
+        main_waiting = true;
+        return;
+    }
+
+    main_time += cycles;
+}
+
+void VirtualSynth::reset_channels()
+{
+    song_buf.clear();
+
+    for(uint8_t n = 0; n <= BUS_APU_FRAME; n++)
+    {
+        song_buf_push(n, 0);
+    }
+
+    for(uint8_t n = 0; n < 3; n++)
+    {
+        song_buf_push(BUS_VRC6 + 4 * n + 2, 0);
+    }
+
+    main_done = true;
+    main_waiting = false;
+
+    send_frame(main_time + bus_start_cycles);
+
+    stop_time = send_end + (uint64_t)(f_cpu * reset_delay_ms / 1000);
+}
+
+bool VirtualSynth::play(const std::string& name, double seconds)
+{
+    fat32_open_root_dir();
+
+    if(!fat32_open_file(name.c_str(), "BIN"))
+    {
+        return false;
+    }
+
+    // Timer 0 starts when the file has been opened
+    max_cycles = seconds * f_cpu;
+    stop_time = UINT64_MAX;
+
+    for(;;)
+    {
+        const uint64_t next_edge = edges.empty() ? UINT64_MAX : edges.front().cycle;
+        const uint64_t next_main = main_done ? UINT64_MAX : main_time;
+
+        Channel *next_ch = 0;
+        uint64_t next_chan = UINT64_MAX;
+
+        for(Channel& ch : channels)
+        {
+            if(!ch.queue.empty() && ch.queue.front().cycle < next_chan)
+            {
+                next_chan = ch.queue.front().cycle;
+                next_ch = &ch;
+            }
+        }
+
+        const uint64_t t = std::min({ next_edge, next_chan, next_tick, next_main });
+
+        if(t >= stop_time)
+        {
+            break;
+        }
+
+        // Interrupts before the main loops
+        if(t == next_edge)
+        {
+            BusEdge edge = edges.front();
+            edges.pop_front();
+            bus_edge(edge);
+        } else if(t == next_tick) {
+            frame_clock();
+        } else if(t == next_chan) {
+            channel_event(*next_ch);
+        } else {
+            main_step();
+        }
+    }
+
+    advance(stop_time);
+    flush();
+
+    fat32_close_file();
+
+    stats.seconds = stop_time / f_cpu;
+    stats.frames = frames_sent;
+
+    return true;
+}
+
+/// Main ///////////////////////////////////////////////////////////////////////////////////////
+
+void print_usage(char *p)
+{
+    fprintf(stderr, "Usage: %s [options] image [song ...]\n"
+            "Play the songs on a virtual NESSynth: the controller reading image, a whole\n"
+            "SD card image, and the channel boards on the bus, and write what the boards\n"
+            "play to dir/<song>.wav. The songs are base names of BIN files, by default\n"
+            "all of them are played.\n"
+            "Options:\n"
+            "  -d dir      Directory of the WAV files (default: the current directory)\n"
+            "  -n          Discard the output\n"
+            "  -s seconds  Seconds to play of each song (default: %d, as the controller)\n"
+            "  -t strobe   Bus strobe of the controller (default: %d)\n"
+            "  -b boards   The IDs of the boards on the bus, see channel/board.h\n"
+            "              (default 0123, the four APU channels)\n"
+            "  -v          Show the log output of the FAT32 driver\n",
+            p, max_play_seconds, bus_strobe_default);
+}
+
+static void print_stats(const std::string& song, const SongStats& s, const std::vector<Channel>& channels)
+{
+    const double frame_us = 1e6 * FRAME_CLOCK_DIV * frame_clock_cycles / f_cpu;
+    const double cycles_us = 1e6 / f_cpu;
+
+    printf("%s: %.1f s, %lu frames, %lu loops\n", song.c_str(), s.seconds, s.frames, s.loops);
+    printf("  Bus:        %.1f%% busy on average, %.1f%% at most\n",
+           s.frames ? 100.0 * s.bus_cycles * cycles_us / s.frames / frame_us : 0.0,
+           100.0 * s.max_bus_cycles * cycles_us / frame_us);
+    printf("  Controller: %u frames buffered at least, %lu underruns, %lu late frames, %.1f ms behind at most\n",
+           s.min_frames == 0xFF ? 0 : s.min_frames, s.underruns, s.late_frames, s.max_drift * cycles_us / 1000);
+    printf("              %.0f SPI bytes/s, main loop %.1f%% busy\n",
+           s.spi_bytes / s.seconds, 100.0 * s.main_cycles / (s.seconds * f_cpu));
+
+    for(const Channel& ch : channels)
+    {
+        const ChannelStats& c = ch.stats;
+
+        printf("  %-11s %lu writes, bus_buf %u deep at most (%.1f on average), %.1f us to write_reg() at most,"
+               " %lu lost edges, %lu overflows\n",
+               (std::string(board_names[ch.board.id()]) + ":").c_str(), c.writes, c.max_depth,
+               c.writes ? c.depth_sum / c.writes : 0.0, c.max_latency * cycles_us, c.lost_edges, c.overflows);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string dir = ".";
+    bool discard = false;
+    double seconds = max_play_seconds;
+    int strobe = bus_strobe_default;
+    std::vector<unsigned> board_ids = { BOARD_SQ1, BOARD_SQ2, BOARD_TRI, BOARD_NOISE };
+
+    int c;
+    while((c = getopt(argc, argv, "d:ns:t:b:v")) != -1)
+    {
+        switch(c)
+        {
+        case 'd':
+            dir = optarg;
+            break;
+
+        case 'n':
+            discard = true;
+            break;
+
+        case 's':
+            seconds = atof(optarg);
+            break;
+
+        case 't':
+            strobe = atoi(optarg);
+            if(strobe < 1 || strobe > 255)
+            {
+                fprintf(stderr, "Error: The strobe is 1-255\n");
+                exit(1);
+            }
+            break;
+
+        case 'b':
+            board_ids.clear();
+            for(const char *p = optarg; *p; p++)
+            {
+                if(*p < '0' || *p >= '0' + NUM_BOARDS)
+                {
+                    fprintf(stderr, "Error: Unknown board ID '%c'\n", *p);
+                    exit(1);
+                }
+                board_ids.push_back(*p - '0');
+            }
+            break;
+
+        case 'v':
+            log_host_enabled = 1;
+            break;
+
+        default:
+            print_usage(argv[0]);
+            exit(1);
+        }
+    }
+
+    if(optind >= argc)
+    {
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    const char *image_name = argv[optind];
+    std::vector<std::string> songs(argv + optind + 1, argv + argc);
+
+    if(songs.empty())
+    {
+        Fat32Image image(image_name);
+
+        for(const Fat32Image::Entry& entry : image.root_dir())
+        {
+            if(entry.is_file() && !memcmp(&entry.name[8], "BIN", 3))
+            {
+                songs.push_back(entry.filename().substr(0, entry.filename().find('.')));
+            }
+        }
+    }
+
+    if(!sd_image_open(image_name))
+    {
+        fprintf(stderr, "Error: Could not open file %s\n", image_name);
+        exit(1);
+    }
+
+    sd_init();
+    fat32_init();
+
+    double total_seconds = 0;
+    auto start_time = std::chrono::steady_clock::now();
+
+    for(const std::string& song : songs)
+    {
+        const std::string wave_name = dir + "/" + song + ".wav";
+        Wave_Writer *wave = discard ? 0 : new Wave_Writer(sample_rate, wave_name.c_str());
+        VirtualSynth synth(board_ids, strobe, wave);
+
+        bool played = synth.play(song, seconds);
+
+        delete wave;
+
+        if(!played)
+        {
+            fprintf(stderr, "Warning: Could not open %s.BIN\n", song.c_str());
+            if(wave)
+            {
+                remove(wave_name.c_str());
+            }
+            continue;
+        }
+
+        print_stats(song, synth.stats, synth.channels);
+        total_seconds += synth.stats.seconds;
+    }
+
+    sd_image_close();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+    printf("Played %.1f s in %.2f s, %.0fx real time\n", total_seconds, elapsed.count(),
+           elapsed.count() > 0 ? total_seconds / elapsed.count() : 0.0);
+
+    return 0;
+}